@@ -24,10 +24,24 @@ AABB::~AABB()
 {
 }
 
-void AABB::MakeGizmo()
+void AABB::MakeGizmo(const float alpha)
 {
 	// uses gizmos to draw a box
-	aie::Gizmos::add2DAABB(m_position, GetExtents(), m_colour);
+	aie::Gizmos::add2DAABB(GetInterpolatedPosition(alpha), GetExtents(), m_colour);
+}
+
+Bounds AABB::GetBounds() const
+{
+	Bounds bounds;
+	bounds.min = GetMin();
+	bounds.max = GetMax();
+	return bounds;
+}
+glm::vec2 AABB::Support(const glm::vec2 & direction) const
+{
+	glm::vec2 min = GetMin();
+	glm::vec2 max = GetMax();
+	return glm::vec2((direction.x > 0.0f) ? max.x : min.x, (direction.y > 0.0f) ? max.y : min.y);
 }
 
 void AABB::SetWidth(const float width)
@@ -39,12 +53,14 @@ void AABB::SetHeight(const float height)
 	m_height = height;
 }
 
-std::vector<glm::vec2> AABB::GetCorners() const
-{
-	std::vector<glm::vec2> corners;
-	corners.push_back(GetMin());					// bottom left
-	corners.push_back({ GetMin().x, GetMax().y });	// top left
-	corners.push_back(GetMax());					// top right
-	corners.push_back({ GetMax().x, GetMin().y });	// bottom right
-	return corners;
+std::array<glm::vec2, 4> AABB::GetCorners() const
+{
+	glm::vec2 min = GetMin();
+	glm::vec2 max = GetMax();
+	return { {
+		min,				// bottom left
+		{ min.x, max.y },	// top left
+		max,				// top right
+		{ max.x, min.y }	// bottom right
+	} };
 }
\ No newline at end of file
@@ -1,11 +1,16 @@
 #pragma once
 
 #include "Rigidbody.h"
+#include "ObjectPool.h"
 #include <vector>
+#include <array>
 
 class AABB : public Rigidbody
 {
 public:
+	// the shape type of every object of this class, used to cast to this class without RTTI
+	static const ShapeType SHAPE_TYPE = BOX;
+
 	AABB(const glm::vec2& position, const glm::vec2& velocity, const float width, const float height, const float mass,
 		const glm::vec4& colour = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), const bool kinematic = false, const bool staticRigidbody = false,
 		const float elasticity = 1.0f, const float linearDrag = 0.0f, const float angularDrag = 0.0f, const float s = 0.0f, const float k = 0.0f);
@@ -15,21 +20,29 @@ public:
 		const float elasticity = 1.0f, const float linearDrag = 0.0f, const float angularDrag = 0.0f, const float s = 0.0f, const float k = 0.0f);
 	~AABB();
 
+	// the memory comes from a pool so that spawning and removing boxes doesn't use the heap each time
+	static void* operator new(size_t size) { return ObjectPool<AABB>::Get().Allocate(size); }
+	static void operator delete(void* memory, size_t size) { ObjectPool<AABB>::Get().Deallocate(memory, size); }
+
 	// draws the box
-	virtual void MakeGizmo();
+	virtual void MakeGizmo(const float alpha);
+	// the box is already axis aligned so its bounds are its min and max
+	virtual Bounds GetBounds() const;
+	// gets the corner furthest along the direction
+	virtual glm::vec2 Support(const glm::vec2& direction) const;
 
 	void SetWidth(const float width);
 	float GetWidth() const { return m_width; }
 	void SetHeight(const float height);
 	float GetHeight() const { return m_height; }
 	// subtracts half the width from the x position and half the height from the y position to get the minimum position that lies within the box
-	glm::vec2 GetMin() const { return glm::vec2(m_position.x - (m_width / 2.0f), m_position.y - (m_height / 2.0f)); } // bottom left corner
+	glm::vec2 GetMin() const { return glm::vec2(GetPosition().x - (m_width / 2.0f), GetPosition().y - (m_height / 2.0f)); } // bottom left corner
 	// adds half the width to the x position and half the height to the y position to get the maximum position that lies within the box
-	glm::vec2 GetMax() const { return glm::vec2(m_position.x + (m_width / 2.0f), m_position.y + (m_height / 2.0f)); } // top right corner
+	glm::vec2 GetMax() const { return glm::vec2(GetPosition().x + (m_width / 2.0f), GetPosition().y + (m_height / 2.0f)); } // top right corner
 	// returns half of the width and height
 	glm::vec2 GetExtents() const { return glm::vec2(m_width * 0.5f, m_height * 0.5f); }
-	// returns a collection of the positions of the corners of the AABB
-	std::vector<glm::vec2> GetCorners() const;
+	// returns the positions of the corners of the AABB, a fixed size array so it never needs the heap
+	std::array<glm::vec2, 4> GetCorners() const;
 
 protected:
 	// stores the width of the box
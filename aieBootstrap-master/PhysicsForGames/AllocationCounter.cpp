@@ -0,0 +1,47 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// constant initialised, so it is ready before any static constructors allocate
+static std::atomic<unsigned long long> s_allocations(0);
+
+unsigned long long AllocationCounter::GetCount()
+{
+	return s_allocations.load(std::memory_order_relaxed);
+}
+
+#ifdef PHYSICS_ALLOCATION_COUNTER
+// replaces the global allocation functions, the array and sized versions all end up here
+void* operator new(size_t size)
+{
+	s_allocations.fetch_add(1, std::memory_order_relaxed);
+	// the standard requires a unique pointer even when nothing is asked for
+	void* memory = malloc(size > 0 ? size : 1);
+	if (memory == nullptr)
+	{
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+void operator delete(void* memory) noexcept
+{
+	free(memory);
+}
+void operator delete[](void* memory) noexcept
+{
+	free(memory);
+}
+void operator delete(void* memory, size_t) noexcept
+{
+	free(memory);
+}
+void operator delete[](void* memory, size_t) noexcept
+{
+	free(memory);
+}
+#endif
\ No newline at end of file
@@ -0,0 +1,12 @@
+#pragma once
+
+// counts the calls made to the global operator new by any thread, used to check that the physics step doesn't use the heap
+// the count includes everything the program allocates, so it is compared before and after the code being checked
+// the global operator new is only replaced when PHYSICS_ALLOCATION_COUNTER is defined, which the debug configurations do,
+// otherwise the count stays at 0
+class AllocationCounter
+{
+public:
+	// the amount of allocations since the program started
+	static unsigned long long GetCount();
+};
\ No newline at end of file
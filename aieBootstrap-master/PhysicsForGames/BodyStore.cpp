@@ -0,0 +1,252 @@
+#include "BodyStore.h"
+#include "Rigidbody.h"
+
+BodyStore::BodyStore()
+{
+	m_simdLevel = ::GetSimdLevel();
+}
+BodyStore::~BodyStore()
+{
+}
+
+unsigned int BodyStore::Add(Rigidbody * body)
+{
+	unsigned int index = m_bodies.size();
+	m_bodies.push_back(body);
+	m_positionX.push_back(body->GetPosition().x);
+	m_positionY.push_back(body->GetPosition().y);
+	m_velocityX.push_back(body->GetVelocity().x);
+	m_velocityY.push_back(body->GetVelocity().y);
+	m_rotation.push_back(body->GetRotation());
+	m_angularVelocity.push_back(body->GetAngularVelocity());
+	m_inverseMass.push_back((body->GetStatic() || body->GetMass() == 0.0f) ? 0.0f : 1.0f / body->GetMass());
+	m_linearDrag.push_back(body->GetLinearDrag());
+	m_angularDrag.push_back(body->GetAngularDrag());
+	m_dynamic.push_back((body->GetKinematic() || body->GetStatic() || !body->GetAwake()) ? 0 : 0xFFFFFFFF);
+	return index;
+}
+void BodyStore::Remove(const unsigned int index)
+{
+	// moves the last body into the removed body's place so the arrays stay contiguous
+	unsigned int last = m_bodies.size() - 1;
+	if (index != last)
+	{
+		m_bodies[index] = m_bodies[last];
+		m_positionX[index] = m_positionX[last];
+		m_positionY[index] = m_positionY[last];
+		m_velocityX[index] = m_velocityX[last];
+		m_velocityY[index] = m_velocityY[last];
+		m_rotation[index] = m_rotation[last];
+		m_angularVelocity[index] = m_angularVelocity[last];
+		m_inverseMass[index] = m_inverseMass[last];
+		m_linearDrag[index] = m_linearDrag[last];
+		m_angularDrag[index] = m_angularDrag[last];
+		m_dynamic[index] = m_dynamic[last];
+		// the moved body needs to know where its state is now
+		m_bodies[index]->SetStoreIndex(index);
+	}
+
+	m_bodies.pop_back();
+	m_positionX.pop_back();
+	m_positionY.pop_back();
+	m_velocityX.pop_back();
+	m_velocityY.pop_back();
+	m_rotation.pop_back();
+	m_angularVelocity.pop_back();
+	m_inverseMass.pop_back();
+	m_linearDrag.pop_back();
+	m_angularDrag.pop_back();
+	m_dynamic.pop_back();
+}
+
+void BodyStore::Integrate(const glm::vec2 & gravity, const float timeStep)
+{
+	Integrate(gravity, timeStep, 0, m_bodies.size());
+}
+void BodyStore::Integrate(const glm::vec2 & gravity, const float timeStep, const unsigned int begin, const unsigned int end)
+{
+	// the simd paths leave the bodies that don't fill a whole register for the scalar loop
+	unsigned int integrated = begin;
+	if (m_simdLevel == SIMD_AVX2)
+	{
+		integrated = IntegrateAVX2(begin, end, gravity, timeStep);
+	}
+	else if (m_simdLevel == SIMD_SSE2)
+	{
+		integrated = IntegrateSSE2(begin, end, gravity, timeStep);
+	}
+	IntegrateScalar(integrated, end, gravity, timeStep);
+}
+
+void BodyStore::SetSimdLevel(const SimdLevel simdLevel)
+{
+	SimdLevel supported = ::GetSimdLevel();
+	m_simdLevel = (simdLevel > supported) ? supported : simdLevel;
+}
+
+// does the same as Rigidbody::FixedUpdate for every body
+void BodyStore::IntegrateScalar(const unsigned int begin, const unsigned int end, const glm::vec2 & gravity, const float timeStep)
+{
+	for (unsigned int i = begin; i < end; i++)
+	{
+		if (m_dynamic[i] == 0)
+		{
+			continue;
+		}
+
+		// applies the force due to gravity
+		float velocityX = m_velocityX[i] + gravity.x * timeStep;
+		float velocityY = m_velocityY[i] + gravity.y * timeStep;
+		// moves the body based on the displacement created by the velocity
+		m_positionX[i] += velocityX * timeStep;
+		m_positionY[i] += velocityY * timeStep;
+		// rotates the body based on the angular velocity
+		float angularVelocity = m_angularVelocity[i];
+		m_rotation[i] += angularVelocity * timeStep;
+
+		// decreases the velocities based on the drag
+		velocityX -= velocityX * m_linearDrag[i] * timeStep;
+		velocityY -= velocityY * m_linearDrag[i] * timeStep;
+		angularVelocity -= angularVelocity * m_angularDrag[i] * timeStep;
+
+		// if the velocity is small enough to be below the threshold then it is set to 0
+		if (sqrtf(velocityX * velocityX + velocityY * velocityY) < MIN_LINEAR_THRESHOLD)
+		{
+			velocityX = 0.0f;
+			velocityY = 0.0f;
+		}
+		if (fabsf(angularVelocity) < MIN_ROTATION_THRESHOLD)
+		{
+			angularVelocity = 0.0f;
+		}
+
+		m_velocityX[i] = velocityX;
+		m_velocityY[i] = velocityY;
+		m_angularVelocity[i] = angularVelocity;
+	}
+}
+
+#if SIMD_X86
+// picks the value from a where the mask is set and from b everywhere else
+static inline __m128 Select(const __m128 mask, const __m128 a, const __m128 b)
+{
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+#endif
+
+// the simd paths do the same operations in the same order as the scalar loop and never fuse a multiply and add
+// sqrt is correctly rounded in both, so the results are bit for bit the same as Rigidbody::FixedUpdate
+// (the tolerance is 0, or 1 ulp per step if the compiler is allowed to contract the scalar code into fma instructions)
+unsigned int BodyStore::IntegrateSSE2(const unsigned int begin, const unsigned int end, const glm::vec2 & gravity, const float timeStep)
+{
+#if SIMD_X86
+	const __m128 gravityX = _mm_set1_ps(gravity.x * timeStep);
+	const __m128 gravityY = _mm_set1_ps(gravity.y * timeStep);
+	const __m128 step = _mm_set1_ps(timeStep);
+	const __m128 linearThreshold = _mm_set1_ps(MIN_LINEAR_THRESHOLD);
+	const __m128 rotationThreshold = _mm_set1_ps(MIN_ROTATION_THRESHOLD);
+	// clears the sign bit
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+	unsigned int stop = begin + ((end - begin) & ~3u);
+	for (unsigned int i = begin; i < stop; i += 4)
+	{
+		__m128 dynamic = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)&m_dynamic[i]));
+		__m128 oldVelocityX = _mm_loadu_ps(&m_velocityX[i]);
+		__m128 oldVelocityY = _mm_loadu_ps(&m_velocityY[i]);
+		__m128 oldAngularVelocity = _mm_loadu_ps(&m_angularVelocity[i]);
+		__m128 positionX = _mm_loadu_ps(&m_positionX[i]);
+		__m128 positionY = _mm_loadu_ps(&m_positionY[i]);
+		__m128 rotation = _mm_loadu_ps(&m_rotation[i]);
+
+		// applies the force due to gravity
+		__m128 velocityX = _mm_add_ps(oldVelocityX, gravityX);
+		__m128 velocityY = _mm_add_ps(oldVelocityY, gravityY);
+		// moves and rotates the bodies, only the dynamic bodies are changed
+		positionX = Select(dynamic, _mm_add_ps(positionX, _mm_mul_ps(velocityX, step)), positionX);
+		positionY = Select(dynamic, _mm_add_ps(positionY, _mm_mul_ps(velocityY, step)), positionY);
+		rotation = Select(dynamic, _mm_add_ps(rotation, _mm_mul_ps(oldAngularVelocity, step)), rotation);
+
+		// decreases the velocities based on the drag
+		__m128 linearDrag = _mm_loadu_ps(&m_linearDrag[i]);
+		velocityX = _mm_sub_ps(velocityX, _mm_mul_ps(_mm_mul_ps(velocityX, linearDrag), step));
+		velocityY = _mm_sub_ps(velocityY, _mm_mul_ps(_mm_mul_ps(velocityY, linearDrag), step));
+		__m128 angularVelocity = _mm_sub_ps(oldAngularVelocity, _mm_mul_ps(_mm_mul_ps(oldAngularVelocity, _mm_loadu_ps(&m_angularDrag[i])), step));
+
+		// keeps the velocities that are not below the thresholds, not less than is used so nan is kept like the scalar code
+		__m128 speed = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(velocityX, velocityX), _mm_mul_ps(velocityY, velocityY)));
+		__m128 moving = _mm_cmpnlt_ps(speed, linearThreshold);
+		__m128 rotating = _mm_cmpnlt_ps(_mm_and_ps(angularVelocity, absMask), rotationThreshold);
+		velocityX = _mm_and_ps(velocityX, moving);
+		velocityY = _mm_and_ps(velocityY, moving);
+		angularVelocity = _mm_and_ps(angularVelocity, rotating);
+
+		_mm_storeu_ps(&m_positionX[i], positionX);
+		_mm_storeu_ps(&m_positionY[i], positionY);
+		_mm_storeu_ps(&m_rotation[i], rotation);
+		_mm_storeu_ps(&m_velocityX[i], Select(dynamic, velocityX, oldVelocityX));
+		_mm_storeu_ps(&m_velocityY[i], Select(dynamic, velocityY, oldVelocityY));
+		_mm_storeu_ps(&m_angularVelocity[i], Select(dynamic, angularVelocity, oldAngularVelocity));
+	}
+	return stop;
+#else
+	return begin;
+#endif
+}
+
+// the same as IntegrateSSE2 with 8 bodies at a time
+SIMD_AVX2_FUNCTION unsigned int BodyStore::IntegrateAVX2(const unsigned int begin, const unsigned int end, const glm::vec2 & gravity, const float timeStep)
+{
+#if SIMD_X86
+	const __m256 gravityX = _mm256_set1_ps(gravity.x * timeStep);
+	const __m256 gravityY = _mm256_set1_ps(gravity.y * timeStep);
+	const __m256 step = _mm256_set1_ps(timeStep);
+	const __m256 linearThreshold = _mm256_set1_ps(MIN_LINEAR_THRESHOLD);
+	const __m256 rotationThreshold = _mm256_set1_ps(MIN_ROTATION_THRESHOLD);
+	const __m256 absMask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+
+	unsigned int stop = begin + ((end - begin) & ~7u);
+	for (unsigned int i = begin; i < stop; i += 8)
+	{
+		__m256 dynamic = _mm256_castsi256_ps(_mm256_loadu_si256((const __m256i*)&m_dynamic[i]));
+		__m256 oldVelocityX = _mm256_loadu_ps(&m_velocityX[i]);
+		__m256 oldVelocityY = _mm256_loadu_ps(&m_velocityY[i]);
+		__m256 oldAngularVelocity = _mm256_loadu_ps(&m_angularVelocity[i]);
+		__m256 positionX = _mm256_loadu_ps(&m_positionX[i]);
+		__m256 positionY = _mm256_loadu_ps(&m_positionY[i]);
+		__m256 rotation = _mm256_loadu_ps(&m_rotation[i]);
+
+		// applies the force due to gravity
+		__m256 velocityX = _mm256_add_ps(oldVelocityX, gravityX);
+		__m256 velocityY = _mm256_add_ps(oldVelocityY, gravityY);
+		// moves and rotates the bodies, only the dynamic bodies are changed
+		positionX = _mm256_blendv_ps(positionX, _mm256_add_ps(positionX, _mm256_mul_ps(velocityX, step)), dynamic);
+		positionY = _mm256_blendv_ps(positionY, _mm256_add_ps(positionY, _mm256_mul_ps(velocityY, step)), dynamic);
+		rotation = _mm256_blendv_ps(rotation, _mm256_add_ps(rotation, _mm256_mul_ps(oldAngularVelocity, step)), dynamic);
+
+		// decreases the velocities based on the drag
+		__m256 linearDrag = _mm256_loadu_ps(&m_linearDrag[i]);
+		velocityX = _mm256_sub_ps(velocityX, _mm256_mul_ps(_mm256_mul_ps(velocityX, linearDrag), step));
+		velocityY = _mm256_sub_ps(velocityY, _mm256_mul_ps(_mm256_mul_ps(velocityY, linearDrag), step));
+		__m256 angularVelocity = _mm256_sub_ps(oldAngularVelocity, _mm256_mul_ps(_mm256_mul_ps(oldAngularVelocity, _mm256_loadu_ps(&m_angularDrag[i])), step));
+
+		// keeps the velocities that are not below the thresholds
+		__m256 speed = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(velocityX, velocityX), _mm256_mul_ps(velocityY, velocityY)));
+		__m256 moving = _mm256_cmp_ps(speed, linearThreshold, _CMP_NLT_UQ);
+		__m256 rotating = _mm256_cmp_ps(_mm256_and_ps(angularVelocity, absMask), rotationThreshold, _CMP_NLT_UQ);
+		velocityX = _mm256_and_ps(velocityX, moving);
+		velocityY = _mm256_and_ps(velocityY, moving);
+		angularVelocity = _mm256_and_ps(angularVelocity, rotating);
+
+		_mm256_storeu_ps(&m_positionX[i], positionX);
+		_mm256_storeu_ps(&m_positionY[i], positionY);
+		_mm256_storeu_ps(&m_rotation[i], rotation);
+		_mm256_storeu_ps(&m_velocityX[i], _mm256_blendv_ps(oldVelocityX, velocityX, dynamic));
+		_mm256_storeu_ps(&m_velocityY[i], _mm256_blendv_ps(oldVelocityY, velocityY, dynamic));
+		_mm256_storeu_ps(&m_angularVelocity[i], _mm256_blendv_ps(oldAngularVelocity, angularVelocity, dynamic));
+	}
+	return stop;
+#else
+	return begin;
+#endif
+}
\ No newline at end of file
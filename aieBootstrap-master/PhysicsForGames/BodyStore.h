@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include "PhysicsObject.h"
+#include "Simd.h"
+
+class Rigidbody;
+
+// stores the state of rigidbodies in contiguous arrays (structure of arrays)
+// rigidbodies that are added to the store read and write their state here, so they become handles into the arrays
+// this lets every body be integrated in one pass over tightly packed memory instead of a virtual call per body
+class BodyStore
+{
+public:
+	BodyStore();
+	~BodyStore();
+
+	// copies the state of the body into the arrays and returns the index it was stored at
+	unsigned int Add(Rigidbody* body);
+	// removes the body at the index, the last body is moved into its place
+	void Remove(const unsigned int index);
+	// integrates every dynamic body with a single pass over the arrays
+	// uses the widest instruction set allowed by the simd level, the results match Rigidbody::FixedUpdate exactly (see IntegrateSSE2)
+	void Integrate(const glm::vec2& gravity, const float timeStep);
+	// integrates the bodies from begin up to but not including end, separate ranges can be integrated on separate threads
+	void Integrate(const glm::vec2& gravity, const float timeStep, const unsigned int begin, const unsigned int end);
+
+	// limits the instruction set used by Integrate, levels the cpu doesn't support are lowered to the best one it does
+	void SetSimdLevel(const SimdLevel simdLevel);
+	SimdLevel GetSimdLevel() const { return m_simdLevel; }
+
+	unsigned int GetCount() const { return m_bodies.size(); }
+	Rigidbody* GetBody(const unsigned int index) const { return m_bodies[index]; }
+
+	glm::vec2 GetPosition(const unsigned int index) const { return glm::vec2(m_positionX[index], m_positionY[index]); }
+	void SetPosition(const unsigned int index, const glm::vec2& position) { m_positionX[index] = position.x; m_positionY[index] = position.y; }
+	glm::vec2 GetVelocity(const unsigned int index) const { return glm::vec2(m_velocityX[index], m_velocityY[index]); }
+	void SetVelocity(const unsigned int index, const glm::vec2& velocity) { m_velocityX[index] = velocity.x; m_velocityY[index] = velocity.y; }
+	float GetRotation(const unsigned int index) const { return m_rotation[index]; }
+	void SetRotation(const unsigned int index, const float rotation) { m_rotation[index] = rotation; }
+	float GetAngularVelocity(const unsigned int index) const { return m_angularVelocity[index]; }
+	void SetAngularVelocity(const unsigned int index, const float angularVelocity) { m_angularVelocity[index] = angularVelocity; }
+	float GetInverseMass(const unsigned int index) const { return m_inverseMass[index]; }
+	void SetInverseMass(const unsigned int index, const float inverseMass) { m_inverseMass[index] = inverseMass; }
+	void SetLinearDrag(const unsigned int index, const float linearDrag) { m_linearDrag[index] = linearDrag; }
+	void SetAngularDrag(const unsigned int index, const float angularDrag) { m_angularDrag[index] = angularDrag; }
+	// dynamic bodies are awake and neither static nor kinematic
+	void SetDynamic(const unsigned int index, const bool dynamic) { m_dynamic[index] = dynamic ? 0xFFFFFFFF : 0; }
+
+protected:
+	// integrates the bodies from begin up to but not including end one at a time
+	void IntegrateScalar(const unsigned int begin, const unsigned int end, const glm::vec2& gravity, const float timeStep);
+	// integrate the bodies in groups of 4 or 8 and return the index they stopped at, the rest are left for the scalar loop
+	unsigned int IntegrateSSE2(const unsigned int begin, const unsigned int end, const glm::vec2& gravity, const float timeStep);
+	unsigned int IntegrateAVX2(const unsigned int begin, const unsigned int end, const glm::vec2& gravity, const float timeStep);
+
+protected:
+	// the body that owns each index
+	std::vector<Rigidbody*> m_bodies;
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionY;
+	std::vector<float> m_velocityX;
+	std::vector<float> m_velocityY;
+	std::vector<float> m_rotation;
+	std::vector<float> m_angularVelocity;
+	// 0 for bodies that can't be moved by forces
+	std::vector<float> m_inverseMass;
+	std::vector<float> m_linearDrag;
+	std::vector<float> m_angularDrag;
+	// all bits are set if the body is integrated, so it can be used as a mask by the simd code
+	std::vector<unsigned int> m_dynamic;
+	// the instruction set used by Integrate
+	SimdLevel m_simdLevel;
+};
\ No newline at end of file
@@ -0,0 +1,337 @@
+#include "BoundsTree.h"
+#include "Broadphase.h"
+#include <algorithm>
+
+BoundsTree::BoundsTree()
+{
+	m_root = NULL_NODE;
+	m_freeList = NULL_NODE;
+}
+BoundsTree::~BoundsTree()
+{
+}
+
+int BoundsTree::Insert(const Bounds & bounds, const unsigned int index)
+{
+	int leaf = AllocateNode();
+	m_nodes[leaf].bounds = bounds;
+	m_nodes[leaf].index = index;
+	m_nodes[leaf].height = 0;
+	InsertLeaf(leaf);
+	return leaf;
+}
+void BoundsTree::Remove(const int node)
+{
+	RemoveLeaf(node);
+	FreeNode(node);
+}
+void BoundsTree::Clear()
+{
+	m_nodes.clear();
+	m_root = NULL_NODE;
+	m_freeList = NULL_NODE;
+}
+
+void BoundsTree::Query(const Bounds & bounds, std::vector<unsigned int>& results) const
+{
+	// none of the leaves below a node can overlap if the node itself doesn't
+	Walk([&](const Bounds& node)
+	{
+		return Broadphase::Overlap(node, bounds);
+	}, results);
+}
+void BoundsTree::QueryRay(const QuerySegment & segment, std::vector<unsigned int>& results) const
+{
+	Walk([&](const Bounds& node)
+	{
+		return segment.Overlaps(node);
+	}, results);
+}
+
+Bounds BoundsTree::Combine(const Bounds & bounds1, const Bounds & bounds2)
+{
+	Bounds bounds;
+	bounds.min = glm::min(bounds1.min, bounds2.min);
+	bounds.max = glm::max(bounds1.max, bounds2.max);
+	return bounds;
+}
+float BoundsTree::Perimeter(const Bounds & bounds)
+{
+	return 2.0f * ((bounds.max.x - bounds.min.x) + (bounds.max.y - bounds.min.y));
+}
+
+int BoundsTree::AllocateNode()
+{
+	int node;
+	if (m_freeList != NULL_NODE)
+	{
+		// reuses a node from the free list
+		node = m_freeList;
+		m_freeList = m_nodes[node].parent;
+	}
+	else
+	{
+		node = m_nodes.size();
+		m_nodes.push_back(TreeNode());
+	}
+
+	m_nodes[node].parent = NULL_NODE;
+	m_nodes[node].child1 = NULL_NODE;
+	m_nodes[node].child2 = NULL_NODE;
+	m_nodes[node].height = 0;
+	m_nodes[node].index = 0;
+	return node;
+}
+void BoundsTree::FreeNode(const int node)
+{
+	m_nodes[node].parent = m_freeList;
+	m_nodes[node].height = -1;
+	m_freeList = node;
+}
+
+void BoundsTree::InsertLeaf(const int leaf)
+{
+	if (m_root == NULL_NODE)
+	{
+		m_root = leaf;
+		m_nodes[leaf].parent = NULL_NODE;
+		return;
+	}
+
+	// walks down the tree to find the best sibling for the leaf
+	Bounds leafBounds = m_nodes[leaf].bounds;
+	int index = m_root;
+	while (!m_nodes[index].IsLeaf())
+	{
+		int child1 = m_nodes[index].child1;
+		int child2 = m_nodes[index].child2;
+
+		float perimeter = Perimeter(m_nodes[index].bounds);
+		float combinedPerimeter = Perimeter(Combine(m_nodes[index].bounds, leafBounds));
+
+		// the cost of making a new parent for this node and the leaf
+		float cost = 2.0f * combinedPerimeter;
+		// the minimum cost that will be added to this node if the leaf is pushed further down
+		float inheritanceCost = 2.0f * (combinedPerimeter - perimeter);
+
+		// the cost of pushing the leaf down to each child
+		float cost1 = Perimeter(Combine(leafBounds, m_nodes[child1].bounds)) + inheritanceCost;
+		if (!m_nodes[child1].IsLeaf())
+		{
+			cost1 -= Perimeter(m_nodes[child1].bounds);
+		}
+		float cost2 = Perimeter(Combine(leafBounds, m_nodes[child2].bounds)) + inheritanceCost;
+		if (!m_nodes[child2].IsLeaf())
+		{
+			cost2 -= Perimeter(m_nodes[child2].bounds);
+		}
+
+		// stops if this node is the cheapest sibling
+		if (cost < cost1 && cost < cost2)
+		{
+			break;
+		}
+		index = (cost1 < cost2) ? child1 : child2;
+	}
+	int sibling = index;
+
+	// creates a new parent for the sibling and the leaf
+	int oldParent = m_nodes[sibling].parent;
+	int newParent = AllocateNode();
+	m_nodes[newParent].parent = oldParent;
+	m_nodes[newParent].bounds = Combine(leafBounds, m_nodes[sibling].bounds);
+	m_nodes[newParent].height = m_nodes[sibling].height + 1;
+	m_nodes[newParent].child1 = sibling;
+	m_nodes[newParent].child2 = leaf;
+	m_nodes[sibling].parent = newParent;
+	m_nodes[leaf].parent = newParent;
+
+	// the new parent takes the place of the sibling
+	if (oldParent != NULL_NODE)
+	{
+		if (m_nodes[oldParent].child1 == sibling)
+		{
+			m_nodes[oldParent].child1 = newParent;
+		}
+		else
+		{
+			m_nodes[oldParent].child2 = newParent;
+		}
+	}
+	else
+	{
+		m_root = newParent;
+	}
+
+	Refit(m_nodes[leaf].parent);
+}
+void BoundsTree::RemoveLeaf(const int leaf)
+{
+	if (leaf == m_root)
+	{
+		m_root = NULL_NODE;
+		return;
+	}
+
+	int parent = m_nodes[leaf].parent;
+	int grandParent = m_nodes[parent].parent;
+	int sibling = (m_nodes[parent].child1 == leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+	// the sibling takes the place of the parent
+	if (grandParent != NULL_NODE)
+	{
+		if (m_nodes[grandParent].child1 == parent)
+		{
+			m_nodes[grandParent].child1 = sibling;
+		}
+		else
+		{
+			m_nodes[grandParent].child2 = sibling;
+		}
+		m_nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		Refit(grandParent);
+	}
+	else
+	{
+		m_root = sibling;
+		m_nodes[sibling].parent = NULL_NODE;
+		FreeNode(parent);
+	}
+}
+
+int BoundsTree::Balance(const int node)
+{
+	TreeNode& a = m_nodes[node];
+	if (a.IsLeaf() || a.height < 2)
+	{
+		return node;
+	}
+
+	int indexB = a.child1;
+	int indexC = a.child2;
+	TreeNode& b = m_nodes[indexB];
+	TreeNode& c = m_nodes[indexC];
+	int balance = c.height - b.height;
+
+	// rotates c up
+	if (balance > 1)
+	{
+		int indexF = c.child1;
+		int indexG = c.child2;
+		TreeNode& f = m_nodes[indexF];
+		TreeNode& g = m_nodes[indexG];
+
+		// c takes the place of a
+		c.child1 = node;
+		c.parent = a.parent;
+		a.parent = indexC;
+		if (c.parent != NULL_NODE)
+		{
+			if (m_nodes[c.parent].child1 == node)
+			{
+				m_nodes[c.parent].child1 = indexC;
+			}
+			else
+			{
+				m_nodes[c.parent].child2 = indexC;
+			}
+		}
+		else
+		{
+			m_root = indexC;
+		}
+
+		// the taller child of c stays with c and the other is given to a
+		if (f.height > g.height)
+		{
+			c.child2 = indexF;
+			a.child2 = indexG;
+			g.parent = node;
+			a.bounds = Combine(b.bounds, g.bounds);
+			c.bounds = Combine(a.bounds, f.bounds);
+			a.height = 1 + std::max(b.height, g.height);
+			c.height = 1 + std::max(a.height, f.height);
+		}
+		else
+		{
+			c.child2 = indexG;
+			a.child2 = indexF;
+			f.parent = node;
+			a.bounds = Combine(b.bounds, f.bounds);
+			c.bounds = Combine(a.bounds, g.bounds);
+			a.height = 1 + std::max(b.height, f.height);
+			c.height = 1 + std::max(a.height, g.height);
+		}
+		return indexC;
+	}
+
+	// rotates b up
+	if (balance < -1)
+	{
+		int indexD = b.child1;
+		int indexE = b.child2;
+		TreeNode& d = m_nodes[indexD];
+		TreeNode& e = m_nodes[indexE];
+
+		// b takes the place of a
+		b.child1 = node;
+		b.parent = a.parent;
+		a.parent = indexB;
+		if (b.parent != NULL_NODE)
+		{
+			if (m_nodes[b.parent].child1 == node)
+			{
+				m_nodes[b.parent].child1 = indexB;
+			}
+			else
+			{
+				m_nodes[b.parent].child2 = indexB;
+			}
+		}
+		else
+		{
+			m_root = indexB;
+		}
+
+		// the taller child of b stays with b and the other is given to a
+		if (d.height > e.height)
+		{
+			b.child2 = indexD;
+			a.child1 = indexE;
+			e.parent = node;
+			a.bounds = Combine(c.bounds, e.bounds);
+			b.bounds = Combine(a.bounds, d.bounds);
+			a.height = 1 + std::max(c.height, e.height);
+			b.height = 1 + std::max(a.height, d.height);
+		}
+		else
+		{
+			b.child2 = indexE;
+			a.child1 = indexD;
+			d.parent = node;
+			a.bounds = Combine(c.bounds, d.bounds);
+			b.bounds = Combine(a.bounds, e.bounds);
+			a.height = 1 + std::max(c.height, d.height);
+			b.height = 1 + std::max(a.height, e.height);
+		}
+		return indexB;
+	}
+
+	return node;
+}
+void BoundsTree::Refit(int node)
+{
+	while (node != NULL_NODE)
+	{
+		node = Balance(node);
+
+		int child1 = m_nodes[node].child1;
+		int child2 = m_nodes[node].child2;
+		m_nodes[node].height = 1 + std::max(m_nodes[child1].height, m_nodes[child2].height);
+		m_nodes[node].bounds = Combine(m_nodes[child1].bounds, m_nodes[child2].bounds);
+
+		node = m_nodes[node].parent;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <vector>
+#include "PhysicsObject.h"
+#include "Broadphase.h"
+
+// used instead of an index when a node does not exist
+#define NULL_NODE -1
+
+// a node in the bounding volume tree
+struct TreeNode
+{
+	// leaves store the bounds of an actor, branches store the bounds of both children
+	Bounds bounds;
+	// parent of the node, or the next free node when the node is not in use
+	int parent;
+	// children of the node, a leaf has no children
+	int child1;
+	int child2;
+	// leaves have a height of 0, free nodes have a height of -1
+	int height;
+	// index of the actor in the scene, only used by leaves
+	unsigned int index;
+
+	bool IsLeaf() const { return child1 == NULL_NODE; }
+};
+
+// binary tree of bounds where each branch contains the bounds of its children
+// leaves are inserted where they increase the perimeter of the tree the least, and the tree is rotated to keep it balanced
+class BoundsTree
+{
+public:
+	BoundsTree();
+	~BoundsTree();
+
+	// adds a leaf for the actor and returns the node that it was stored in
+	int Insert(const Bounds& bounds, const unsigned int index);
+	// removes a leaf from the tree
+	void Remove(const int node);
+	// removes every node from the tree
+	void Clear();
+	// adds the index of every leaf that overlaps the bounds to the collection
+	void Query(const Bounds& bounds, std::vector<unsigned int>& results) const;
+	// adds the index of every leaf whose bounds the segment passes through
+	void QueryRay(const QuerySegment& segment, std::vector<unsigned int>& results) const;
+
+	const Bounds& GetBounds(const int node) const { return m_nodes[node].bounds; }
+	void SetIndex(const int node, const unsigned int index) { m_nodes[node].index = index; }
+	const TreeNode& GetNode(const int node) const { return m_nodes[node]; }
+	int GetRoot() const { return m_root; }
+
+	// gets the smallest bounds that contains both bounds
+	static Bounds Combine(const Bounds& bounds1, const Bounds& bounds2);
+	// gets the perimeter of the bounds, used as the cost of a node
+	static float Perimeter(const Bounds& bounds);
+
+protected:
+	// gets an unused node, either from the free list or by adding a new one
+	int AllocateNode();
+	// adds the node to the free list
+	void FreeNode(const int node);
+	// finds the best sibling for the leaf and gives them a new parent
+	void InsertLeaf(const int leaf);
+	// removes the leaf and replaces its parent with its sibling
+	void RemoveLeaf(const int leaf);
+	// rotates the node if one child is more than 1 level taller than the other, returns the node that is now in its place
+	int Balance(const int node);
+	// works out the bounds and height of each node from the node to the root
+	void Refit(int node);
+	// adds the index of every leaf whose bounds pass the test to the collection, only going below the branches that pass it
+	// the walk goes back up through the parents instead of keeping a stack, so it doesn't change the tree and several threads
+	// can query it at once
+	template<typename Test>
+	void Walk(const Test& test, std::vector<unsigned int>& results) const
+	{
+		int node = m_root;
+		while (node != NULL_NODE)
+		{
+			const TreeNode& current = m_nodes[node];
+			if (test(current.bounds))
+			{
+				if (!current.IsLeaf())
+				{
+					node = current.child1;
+					continue;
+				}
+				results.push_back(current.index);
+			}
+
+			// goes up past the second children, whose parents are finished, and then across to the next second child
+			while (node != m_root && m_nodes[m_nodes[node].parent].child2 == node)
+			{
+				node = m_nodes[node].parent;
+			}
+			node = (node != m_root) ? m_nodes[m_nodes[node].parent].child2 : NULL_NODE;
+		}
+	}
+
+protected:
+	// every node in the tree, including free ones
+	std::vector<TreeNode> m_nodes;
+	// the top of the tree
+	int m_root;
+	// the first node in the free list
+	int m_freeList;
+};
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include "PhysicsObject.h"
+#include "Rigidbody.h"
+#include "Sweep.h"
+
+// the broadphase algorithms that can be used by the physics scene
+enum BroadphaseType
+{
+	BRUTE_FORCE = 0, // checks every actor against every other actor
+	UNIFORM_GRID, // only checks actors that share a grid cell
+	SWEEP_AND_PRUNE, // keeps the bounds sorted along each axis between steps
+	DYNAMIC_TREE // stores static and moving actors in separate bounding volume trees
+};
+
+// two actors that might be colliding
+struct CollisionPair
+{
+	// index of the first actor in the scene, always less than the second
+	unsigned int first;
+	// index of the second actor in the scene
+	unsigned int second;
+};
+
+// a segment from start to end with the bounds it is checked against grown by the radius
+// the division is done once when it is set up, so it can be checked against a lot of bounds
+struct QuerySegment
+{
+	QuerySegment(const glm::vec2& start, const glm::vec2& end, const float segmentRadius) : sweep(start, end - start)
+	{
+		radius = segmentRadius;
+	}
+
+	// gets the fractions of the segment where it enters and leaves the bounds grown by the radius, false if it misses them
+	bool Clip(const Bounds& bounds, float& enter, float& exit) const
+	{
+		float enterX, enterY;
+		ClipBox(sweep, bounds.min - radius, bounds.max + radius, enterX, enterY, exit);
+		enter = fmaxf(fmaxf(enterX, enterY), 0.0f);
+		exit = fminf(exit, 1.0f);
+		return enter <= exit;
+	}
+	// checks if the segment passes through the bounds grown by the radius
+	bool Overlaps(const Bounds& bounds) const
+	{
+		float enter, exit;
+		return Clip(bounds, enter, exit);
+	}
+
+	SweepSegment sweep;
+	float radius;
+};
+
+// abstract class
+// finds the pairs of actors whose bounds overlap so that only those pairs are passed to the collision functions
+class Broadphase
+{
+public:
+	virtual ~Broadphase() {}
+
+	// fills the collection with the pairs of actors that could be colliding
+	// the pairs are sorted by first then second so that they are checked in the same order as the brute force loop
+	virtual void FindPairs(const std::vector<PhysicsObject*>& actors, std::vector<CollisionPair>& pairs) = 0;
+	// called after the actor at the index has been removed from the scene so any stored indices can be updated
+	// the scene moves its last actor into the gap, last is the index that actor had and is the same as index if it was the one removed
+	virtual void OnActorRemoved(const unsigned int /*index*/, const unsigned int /*last*/) {}
+	// grows the bounds of the rigidbodies so the pairs include the actors that are apart but close enough for a speculative contact
+	// the bounds are grown by half the margin on every side and stretched along how far the velocity moves the rigidbody in the time
+	void SetExpansion(const float margin, const float time) { m_margin = margin; m_time = time; }
+	// adds the index of every actor whose bounds overlap the bounds to the collection, planes included, each actor only once
+	// uses the bounds from the last call to FindPairs and doesn't change the broadphase, so several threads can query it at once
+	// the indices are only valid until an actor is removed
+	virtual void QueryBounds(const Bounds& bounds, std::vector<unsigned int>& results) const = 0;
+	// adds the index of every actor whose bounds, grown by the radius, the segment from start to end passes through
+	// only the area along the segment is searched, so a long ray doesn't have to look at every actor inside its bounds
+	virtual void QueryRay(const glm::vec2& start, const glm::vec2& end, const float radius, std::vector<unsigned int>& results) const = 0;
+
+	// checks if two bounds overlap
+	static bool Overlap(const Bounds& bounds1, const Bounds& bounds2)
+	{
+		return !(bounds1.min.x > bounds2.max.x || bounds1.min.y > bounds2.max.y ||
+			bounds1.max.x < bounds2.min.x || bounds1.max.y < bounds2.min.y);
+	}
+	// checks if the outer bounds completely contain the inner bounds
+	static bool Contains(const Bounds& outer, const Bounds& inner)
+	{
+		return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y &&
+			outer.max.x >= inner.max.x && outer.max.y >= inner.max.y;
+	}
+	// gets the bounds grown by the distance on every side
+	static Bounds Grow(const Bounds& bounds, const float distance)
+	{
+		Bounds grown;
+		grown.min = bounds.min - distance;
+		grown.max = bounds.max + distance;
+		return grown;
+	}
+	// used to sort the pairs into the order that the brute force loop would check them
+	static bool ComparePairs(const CollisionPair& pair1, const CollisionPair& pair2)
+	{
+		return (pair1.first != pair2.first) ? pair1.first < pair2.first : pair1.second < pair2.second;
+	}
+
+protected:
+	// gets the bounds of the actor grown by the expansion
+	Bounds GetActorBounds(const PhysicsObject* actor) const
+	{
+		Bounds bounds = actor->GetBounds();
+		// planes already cover the whole world
+		if ((m_margin == 0.0f && m_time == 0.0f) || actor->GetShapeType() == PLANE)
+		{
+			return bounds;
+		}
+		glm::vec2 displacement = static_cast<const Rigidbody*>(actor)->GetVelocity() * m_time;
+		bounds.min += glm::min(displacement, glm::vec2(0.0f, 0.0f)) - m_margin * 0.5f;
+		bounds.max += glm::max(displacement, glm::vec2(0.0f, 0.0f)) + m_margin * 0.5f;
+		return bounds;
+	}
+
+protected:
+	// how much the bounds are grown by
+	float m_margin = 0.0f;
+	float m_time = 0.0f;
+};
\ No newline at end of file
@@ -26,7 +26,11 @@ bool CollisionApp::startup()
 
 	m_physicsScene = new PhysicsScene();
 	m_physicsScene->SetGravity(glm::vec2(0, -10.0f));
-	m_physicsScene->SetTimeStep(0.001f);
+	// the actors are drawn between steps, so the scene doesn't need to step every frame to look smooth
+	// the sequential impulse solver keeps the actors stable with a step as long as a frame
+	m_physicsScene->SetTimeStep(1.0f / 60.0f);
+	m_physicsScene->SetSolver(SEQUENTIAL_IMPULSE);
+	m_physicsScene->SetSleeping(true);
 
 	Plane* top = new Plane({ 0.0f, -1.0f }, -55.0f);
 	m_physicsScene->AddActor(top);
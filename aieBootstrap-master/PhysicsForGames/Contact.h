@@ -0,0 +1,25 @@
+#pragma once
+
+#include "PhysicsObject.h"
+
+// the result of a collision check between two actors, used to resolve the collision
+// the collision functions fill these in and PhysicsScene::ResolveContact moves the objects apart and applies the forces
+struct Contact
+{
+	// the object that the normal points away from, planes are always the first object
+	PhysicsObject* object1;
+	// the object that the normal points towards
+	PhysicsObject* object2;
+	// the collision normal, from object1 to object2
+	glm::vec2 normal;
+	// the amount the objects overlap along the normal, negative for a speculative contact between objects that are still apart
+	float overlap;
+	// the point where the friction force is applied
+	glm::vec2 point;
+	// the direction GJK starts searching along, the collision functions that use GJK replace it with the direction they finished with
+	// whether or not the objects collide, zero starts the search along the line between the objects
+	glm::vec2 axis = glm::vec2(0.0f, 0.0f);
+	// how far apart the objects can be and still make a contact, set before the collision function is called
+	// 0 only finds the objects that touch, the scene sets it when speculative contacts are used
+	float margin = 0.0f;
+};
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "ContactCache.h"
+
+// the cosine of the largest angle the normal can turn between steps and still reuse the impulses
+#define NORMAL_TOLERANCE 0.95f
+
+ContactCache::ContactCache()
+{
+	m_step = 0;
+	m_hits = 0;
+	m_misses = 0;
+}
+ContactCache::~ContactCache()
+{
+}
+
+void ContactCache::BeginStep()
+{
+	m_step++;
+}
+void ContactCache::EndStep()
+{
+	for (auto it = m_contacts.begin(); it != m_contacts.end();)
+	{
+		if (it->second.step != m_step)
+		{
+			it = m_contacts.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+}
+
+CachedContact & ContactCache::Find(PhysicsObject * object1, PhysicsObject * object2, const glm::vec2 & normal, const glm::vec2 & point)
+{
+	// searches before inserting because emplace allocates a node even when the pair is already there
+	ContactKey key = { object1->GetHandle(), object2->GetHandle() };
+	auto it = m_contacts.find(key);
+	bool found = it != m_contacts.end();
+	if (!found)
+	{
+		it = m_contacts.emplace(key, CachedContact()).first;
+	}
+	CachedContact& cached = it->second;
+
+	// the pairs that didn't touch last step were removed, so an existing pair was touching last step
+	// the impulses are only useful if the objects are still touching in roughly the same direction
+	if (found && glm::dot(cached.normal, normal) > NORMAL_TOLERANCE)
+	{
+		m_hits++;
+	}
+	else
+	{
+		m_misses++;
+		cached.normalImpulse = 0.0f;
+		cached.tangentImpulse = 0.0f;
+	}
+
+	cached.point = point;
+	cached.normal = normal;
+	cached.step = m_step;
+	return cached;
+}
+void ContactCache::Clear()
+{
+	m_contacts.clear();
+}
\ No newline at end of file
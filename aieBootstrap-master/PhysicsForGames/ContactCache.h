@@ -0,0 +1,77 @@
+#pragma once
+
+#include <unordered_map>
+#include <functional>
+#include "PhysicsObject.h"
+#include "ObjectPool.h"
+
+// the pair of objects a cached contact belongs to, in the order the collision function gave them
+// the handles are used instead of pointers because a removed object's handle is never given out again, so an object created
+// at the same address can't pick up the impulses of the old one
+struct ContactKey
+{
+	ActorHandle object1;
+	ActorHandle object2;
+
+	bool operator==(const ContactKey& other) const { return object1 == other.object1 && object2 == other.object2; }
+};
+
+// combines the slots and generations of the two handles, the order matters because the normal points from the first object to the second
+struct ContactKeyHash
+{
+	size_t operator()(const ContactKey& key) const
+	{
+		unsigned long long handle1 = ((unsigned long long)key.object1.generation << 32) | key.object1.index;
+		unsigned long long handle2 = ((unsigned long long)key.object2.generation << 32) | key.object2.index;
+		return std::hash<unsigned long long>()(handle1) * 31 + std::hash<unsigned long long>()(handle2);
+	}
+};
+
+// the state of a contact that is kept between steps
+struct CachedContact
+{
+	// the contact point and normal from the last step the pair was touching
+	glm::vec2 point;
+	glm::vec2 normal;
+	// the total impulses the solver applied last step, used as the starting impulses this step
+	float normalImpulse;
+	float tangentImpulse;
+	// the step the pair was last touching in
+	unsigned int step;
+};
+
+// keeps the contacts of each pair of touching objects between steps so the solver doesn't start from nothing every step
+// a pair that stops touching is removed at the end of the step, so a pair is only found again if it touched the step before
+// the pairs of a removed object stop touching, so they are dropped at the end of the next step without needing to search for them
+class ContactCache
+{
+public:
+	ContactCache();
+	~ContactCache();
+
+	// starts a new step, the contacts found after this are marked as touching this step
+	void BeginStep();
+	// removes the pairs that didn't touch this step
+	void EndStep();
+	// gets the cached contact for the pair, the impulses are reset if the pair wasn't touching last step or the normal has changed too much
+	// the reference stays valid until the pair is removed
+	CachedContact& Find(PhysicsObject* object1, PhysicsObject* object2, const glm::vec2& normal, const glm::vec2& point);
+	void Clear();
+
+	// the amount of contacts that reused the impulses from the last step
+	unsigned int GetHits() const { return m_hits; }
+	// the amount of contacts that started with no impulse
+	unsigned int GetMisses() const { return m_misses; }
+	void ResetStatistics() { m_hits = 0; m_misses = 0; }
+	// the amount of pairs being kept
+	unsigned int GetCount() const { return m_contacts.size(); }
+
+protected:
+	// the nodes come from a pool because pairs start and stop touching every step
+	std::unordered_map<ContactKey, CachedContact, ContactKeyHash, std::equal_to<ContactKey>,
+		PoolAllocator<std::pair<const ContactKey, CachedContact>>> m_contacts;
+	// incremented at the start of each step
+	unsigned int m_step;
+	unsigned int m_hits;
+	unsigned int m_misses;
+};
\ No newline at end of file
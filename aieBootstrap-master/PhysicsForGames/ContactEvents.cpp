@@ -0,0 +1,93 @@
+#include "ContactEvents.h"
+#include <algorithm>
+
+// packs a handle into one number so the pairs can be compared quickly
+static unsigned long long PackHandle(const ActorHandle& handle)
+{
+	return ((unsigned long long)handle.generation << 32) | handle.index;
+}
+
+ContactEventStream::ContactEventStream()
+{
+	m_capacity = 0;
+	m_writeBuffer = 0;
+	m_written = 0;
+	m_readStart = 0;
+	m_readCount = 0;
+	m_readDropped = 0;
+}
+ContactEventStream::~ContactEventStream()
+{
+}
+
+void ContactEventStream::SetCapacity(const unsigned int capacity)
+{
+	m_capacity = capacity;
+	for (std::vector<ContactEvent>& buffer : m_buffers)
+	{
+		buffer.resize(capacity);
+		buffer.shrink_to_fit();
+	}
+	m_written = 0;
+	m_readStart = 0;
+	m_readCount = 0;
+	m_readDropped = 0;
+	m_touching.clear();
+	m_lastTouching.clear();
+	m_merged.clear();
+	// every touching pair makes an event, so the pairs only need more room once the events don't fit either
+	m_touching.reserve(capacity);
+	m_lastTouching.reserve(capacity);
+	m_merged.reserve(capacity);
+}
+
+const ContactEvent & ContactEventStream::GetEvent(const unsigned int index) const
+{
+	const std::vector<ContactEvent>& buffer = m_buffers[1 - m_writeBuffer];
+	unsigned int slot = m_readStart + index;
+	return buffer[(slot < m_capacity) ? slot : slot - m_capacity];
+}
+
+void ContactEventStream::AddContact(const Contact & contact)
+{
+	if (contact.overlap < 0.0f)
+	{
+		return;
+	}
+	TouchingPair pair;
+	pair.first = PackHandle(contact.object1->GetHandle());
+	pair.second = PackHandle(contact.object2->GetHandle());
+	// the collision functions can give the actors in either order depending on where they are in the scene
+	if (pair.second < pair.first)
+	{
+		std::swap(pair.first, pair.second);
+	}
+	pair.event.object1 = contact.object1->GetHandle();
+	pair.event.object2 = contact.object2->GetHandle();
+	pair.event.point = contact.point;
+	pair.event.normal = contact.normal;
+	pair.event.type = CONTACT_BEGIN;
+	m_touching.push_back(pair);
+}
+
+void ContactEventStream::Swap()
+{
+	m_readStart = (m_written > m_capacity) ? m_written % m_capacity : 0;
+	m_readCount = std::min(m_written, m_capacity);
+	m_readDropped = m_written - m_readCount;
+	m_writeBuffer = 1 - m_writeBuffer;
+	m_written = 0;
+}
+
+void ContactEventStream::SortTouching()
+{
+	// each pair is only checked once a step, so no two pairs are the same
+	std::sort(m_touching.begin(), m_touching.end());
+}
+void ContactEventStream::Write(const ContactEvent & event, const ContactEventType type)
+{
+	ContactEvent& slot = m_buffers[m_writeBuffer][m_written % m_capacity];
+	slot = event;
+	slot.type = type;
+	m_written++;
+}
\ No newline at end of file
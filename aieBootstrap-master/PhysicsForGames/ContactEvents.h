@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+#include "Contact.h"
+
+enum ContactEventType : unsigned char
+{
+	// the pair started touching this step
+	CONTACT_BEGIN,
+	// the pair was touching last step and still is
+	CONTACT_STAY,
+	// the pair was touching last step and isn't any more, or one of the actors has been removed
+	CONTACT_END,
+};
+
+// a record of a pair of actors touching, handles are used so the actors can be looked up safely after being removed
+struct ContactEvent
+{
+	// the actors in the order the collision function gave them, the normal points from the first to the second
+	ActorHandle object1;
+	ActorHandle object2;
+	// the contact found for the pair this step, or the last contact found for it for an end event
+	glm::vec2 point;
+	glm::vec2 normal;
+	ContactEventType type;
+};
+
+// writes begin, stay and end events for the pairs of touching actors into a ring buffer during the steps
+// there are two buffers, the scene writes to one while the events in the other can be read, and they are swapped at the end
+// of each update, so the events from the last update can be read on any thread without locking until the next update ends
+// the buffers are allocated up front, if more events are written than fit then the oldest ones are overwritten
+// speculative contacts between actors that are still apart aren't touching, so they don't make events
+class ContactEventStream
+{
+public:
+	ContactEventStream();
+	~ContactEventStream();
+
+	// allocates room for the amount of events written in one update, 0 stops the events being written
+	// clears the events and the touching pairs, so it can't be called during a step or while the events are being read
+	void SetCapacity(const unsigned int capacity);
+	unsigned int GetCapacity() const { return m_capacity; }
+	bool IsEnabled() const { return m_capacity != 0; }
+
+	// the events written during the last update, from the oldest to the newest
+	// the events of each step are in the order of the handles of the pairs, so they are the same for any amount of threads
+	unsigned int GetEventCount() const { return m_readCount; }
+	const ContactEvent& GetEvent(const unsigned int index) const;
+	// the amount of events from the last update that were overwritten because the buffer was full
+	unsigned int GetDroppedCount() const { return m_readDropped; }
+
+	// adds a contact found this step, it is ignored if the actors don't overlap
+	void AddContact(const Contact& contact);
+	// compares the pairs touching this step with the ones touching last step and writes the events
+	// a pair touching last step that wasn't checked this step is kept without an event if resting returns true for it, so a
+	// pair that is asleep doesn't end and begin again when it is woken
+	template<typename Resting>
+	void EndStep(const Resting& resting);
+	// makes the events written since the last swap readable and starts writing over the older ones
+	void Swap();
+
+protected:
+	// a touching pair with the packed handles of its actors, the lower one first, so it can be sorted and matched between steps
+	struct TouchingPair
+	{
+		unsigned long long first;
+		unsigned long long second;
+		ContactEvent event;
+
+		bool operator<(const TouchingPair& other) const { return first < other.first || (first == other.first && second < other.second); }
+		bool operator==(const TouchingPair& other) const { return first == other.first && second == other.second; }
+	};
+
+protected:
+	// sorts the pairs found this step so they can be merged with the ones from last step
+	void SortTouching();
+	void Write(const ContactEvent& event, const ContactEventType type);
+
+protected:
+	unsigned int m_capacity;
+	// the two ring buffers, each the size of the capacity
+	std::vector<ContactEvent> m_buffers[2];
+	// the buffer being written during the steps, the other one is read
+	unsigned int m_writeBuffer;
+	// the total amount of events written since the last swap, the next one goes in at this modulo the capacity
+	unsigned int m_written;
+	// the events that can be read, the oldest one is at the start
+	unsigned int m_readStart;
+	unsigned int m_readCount;
+	unsigned int m_readDropped;
+	// the pairs touching this step and last step, sorted, and the merged list that replaces the ones from last step
+	std::vector<TouchingPair> m_touching;
+	std::vector<TouchingPair> m_lastTouching;
+	std::vector<TouchingPair> m_merged;
+};
+
+template<typename Resting>
+void ContactEventStream::EndStep(const Resting & resting)
+{
+	SortTouching();
+	m_merged.clear();
+	unsigned int current = 0;
+	unsigned int last = 0;
+	while (current < m_touching.size() || last < m_lastTouching.size())
+	{
+		if (last == m_lastTouching.size() || (current < m_touching.size() && m_touching[current] < m_lastTouching[last]))
+		{
+			Write(m_touching[current].event, CONTACT_BEGIN);
+			m_merged.push_back(m_touching[current++]);
+		}
+		else if (current < m_touching.size() && m_touching[current] == m_lastTouching[last])
+		{
+			Write(m_touching[current].event, CONTACT_STAY);
+			m_merged.push_back(m_touching[current++]);
+			last++;
+		}
+		else if (resting(m_lastTouching[last].event))
+		{
+			m_merged.push_back(m_lastTouching[last++]);
+		}
+		else
+		{
+			Write(m_lastTouching[last++].event, CONTACT_END);
+		}
+	}
+	m_lastTouching.swap(m_merged);
+	m_touching.clear();
+}
\ No newline at end of file
@@ -0,0 +1,483 @@
+#include <algorithm>
+#include "ContactSolver.h"
+#include "PhysicsScene.h"
+
+// the defaults used by the solver
+#define DEFAULT_ITERATIONS 10
+#define DEFAULT_POSITION_ITERATIONS 3
+#define DEFAULT_BAUMGARTE 0.4f
+#define DEFAULT_SLOP 0.05f
+// bodies that hit each other slower than this don't bounce, so resting contacts don't keep bouncing from gravity
+#define RESTITUTION_THRESHOLD 1.0f
+// bodies sliding past each other slower than this use the static friction coefficients
+#define STATIC_FRICTION_THRESHOLD 0.1f
+// the furthest a contact can move its bodies in one position iteration, so a deep overlap is pushed out over a few steps
+#define MAX_CORRECTION 0.5f
+// the amount of colors that fit in the bits used to mark the colors of each body
+#define MAX_COLORS 64
+// colors with fewer contacts than this are solved on the calling thread because splitting them would cost more than it saves
+#define MIN_PARALLEL_CONTACTS 256
+// the islands are only solved as separate tasks if the largest island has no more than this share of the contacts,
+// otherwise one thread would be left solving most of the step while the others wait, and splitting the colors is faster
+#define MAX_ISLAND_SHARE 0.5f
+// marks a body that hasn't been given an island yet
+#define NO_SOLVER_ISLAND 0xFFFFFFFF
+
+// gets the histogram bucket for the size, the bucket is the index of the highest bit that is set
+static unsigned int HistogramBucket(unsigned int size)
+{
+	unsigned int bucket = 0;
+	while (size > 1)
+	{
+		size >>= 1;
+		bucket++;
+	}
+	return bucket;
+}
+
+ContactSolver::ContactSolver()
+{
+	m_iterations = DEFAULT_ITERATIONS;
+	m_positionIterations = DEFAULT_POSITION_ITERATIONS;
+	m_baumgarte = DEFAULT_BAUMGARTE;
+	m_slop = DEFAULT_SLOP;
+	m_warmStarting = true;
+	m_colorCount = 0;
+	m_islandCount = 0;
+	m_largestIsland = 0;
+	m_solvedIslands = false;
+}
+ContactSolver::~ContactSolver()
+{
+}
+
+void ContactSolver::Solve(const std::vector<Contact>& contacts, const float timeStep, WorkerPool* workers)
+{
+	m_cache.BeginStep();
+	PrepareContacts(contacts, timeStep);
+	ColorContacts();
+	BuildIslands();
+
+	// the islands are picked up by whichever worker is free, the result doesn't depend on which thread solves each island
+	m_solvedIslands = workers != nullptr && m_islandCount > 1 && m_largestIsland <= m_contacts.size() * MAX_ISLAND_SHARE;
+	if (m_solvedIslands)
+	{
+		workers->RunTasks(m_islandCount, [this](unsigned int index, unsigned int /*thread*/)
+		{
+			SolveIsland(m_islandOrder[index]);
+		});
+	}
+	else
+	{
+		if (m_warmStarting)
+		{
+			RunStage(WARM_START_STAGE, workers);
+		}
+
+		// every iteration moves each contact closer to being solved without undoing too much of the other contacts
+		for (unsigned int i = 0; i < m_iterations; i++)
+		{
+			RunStage(VELOCITY_STAGE, workers);
+		}
+
+		// the overlap is only removed once the velocities are solved, so the corrections don't change the velocities
+		for (unsigned int i = 0; i < m_positionIterations; i++)
+		{
+			RunStage(POSITION_STAGE, workers);
+		}
+	}
+
+	StoreResults();
+	// forgets the pairs that have stopped touching
+	m_cache.EndStep();
+}
+
+unsigned int ContactSolver::AddBody(PhysicsObject * obj)
+{
+	// planes and static rigidbodies never move, so they can all share the body at index 0
+	if (obj->GetShapeType() == PLANE || static_cast<Rigidbody*>(obj)->GetStatic())
+	{
+		return 0;
+	}
+
+	// the index is only trusted if it points back at the rigidbody, so it doesn't need to be cleared after each step
+	Rigidbody* body = static_cast<Rigidbody*>(obj);
+	unsigned int index = body->GetSolverIndex();
+	if (index < m_bodies.size() && m_bodies[index].body == body)
+	{
+		return index;
+	}
+
+	index = m_bodies.size();
+	m_bodies.push_back({ body, body->GetVelocity(), glm::vec2(0.0f, 0.0f), 1.0f / body->GetMass() });
+	body->SetSolverIndex(index);
+	return index;
+}
+void ContactSolver::PrepareContacts(const std::vector<Contact>& contacts, const float timeStep)
+{
+	m_bodies.clear();
+	m_contacts.clear();
+	m_bodies.push_back({ nullptr, glm::vec2(0.0f, 0.0f), glm::vec2(0.0f, 0.0f), 0.0f });
+
+	for (const Contact& contact : contacts)
+	{
+		// kinematic objects and pairs of static objects aren't resolved
+		if (!PhysicsScene::CanResolve(contact.object1, contact.object2))
+		{
+			continue;
+		}
+		// the sphere to sphere and box to box checks use the direction between the centers, which isn't a number when the
+		// centers are in the same place
+		// a normal that isn't a number would spread to every body in the stack
+		if (glm::any(glm::isnan(contact.normal)))
+		{
+			continue;
+		}
+
+		SolverContact solverContact;
+		solverContact.body1 = AddBody(contact.object1);
+		solverContact.body2 = AddBody(contact.object2);
+		const SolverBody& body1 = m_bodies[solverContact.body1];
+		const SolverBody& body2 = m_bodies[solverContact.body2];
+
+		solverContact.normal = contact.normal;
+		solverContact.tangent = glm::vec2(-contact.normal.y, contact.normal.x);
+		solverContact.mass = 1.0f / (body1.inverseMass + body2.inverseMass);
+		solverContact.cached = &m_cache.Find(contact.object1, contact.object2, contact.normal, contact.point);
+		solverContact.normalImpulse = m_warmStarting ? solverContact.cached->normalImpulse : 0.0f;
+		solverContact.tangentImpulse = 0.0f;
+
+		glm::vec2 relativeVelocity = body2.velocity - body1.velocity;
+		float normalVelocity = glm::dot(relativeVelocity, contact.normal);
+
+		// uses the average elasticity if both objects can move, otherwise the elasticity of the one that can
+		float elasticity;
+		if (body1.body != nullptr && body2.body != nullptr)
+		{
+			elasticity = (body1.body->GetElasticity() + body2.body->GetElasticity()) / 2.0f;
+		}
+		else
+		{
+			elasticity = (body1.body != nullptr) ? body1.body->GetElasticity() : body2.body->GetElasticity();
+		}
+		solverContact.bias = (normalVelocity < -RESTITUTION_THRESHOLD) ? -elasticity * normalVelocity : 0.0f;
+		// the bodies of a speculative contact are still apart, so they don't bounce and only the speed that would make them
+		// overlap by the next step is removed, they land on each other and bounce once they are touching
+		if (contact.overlap < 0.0f)
+		{
+			solverContact.bias = contact.overlap / timeStep;
+		}
+		solverContact.overlap = contact.overlap;
+
+		// uses the average friction of the two objects, the same as the immediate resolution
+		if (fabsf(glm::dot(relativeVelocity, solverContact.tangent)) < STATIC_FRICTION_THRESHOLD)
+		{
+			solverContact.friction = (contact.object1->GetStaticFriction() + contact.object2->GetStaticFriction()) / 2.0f;
+		}
+		else
+		{
+			solverContact.friction = (contact.object1->GetKineticFriction() + contact.object2->GetKineticFriction()) / 2.0f;
+		}
+		// the friction might have changed between static and kinetic, so the old friction impulse is kept within the new limit
+		if (m_warmStarting)
+		{
+			float maxFriction = solverContact.friction * solverContact.normalImpulse;
+			solverContact.tangentImpulse = fmaxf(-maxFriction, fminf(solverContact.cached->tangentImpulse, maxFriction));
+		}
+
+		m_contacts.push_back(solverContact);
+	}
+}
+void ContactSolver::ColorContacts()
+{
+	m_bodyColors.assign(m_bodies.size(), 0);
+	m_contactColors.resize(m_contacts.size());
+	// counts the contacts in each color, offset by one so that the counts become the starts of the colors
+	m_colorStart.assign(MAX_COLORS + 2, 0);
+
+	for (unsigned int i = 0; i < m_contacts.size(); i++)
+	{
+		const SolverContact& contact = m_contacts[i];
+		// the static body never gets any colors, so the contacts that only share it can have the same color
+		unsigned long long used = m_bodyColors[contact.body1] | m_bodyColors[contact.body2];
+		// uses the first color that neither body has used yet, a contact between two busy bodies goes in the extra color
+		unsigned int color = 0;
+		while (color < MAX_COLORS && (used & (1ull << color)) != 0)
+		{
+			color++;
+		}
+		if (color < MAX_COLORS)
+		{
+			if (contact.body1 != 0)
+			{
+				m_bodyColors[contact.body1] |= 1ull << color;
+			}
+			if (contact.body2 != 0)
+			{
+				m_bodyColors[contact.body2] |= 1ull << color;
+			}
+		}
+		m_contactColors[i] = color;
+		m_colorStart[color + 1]++;
+	}
+
+	m_colorCount = 0;
+	for (unsigned int color = 0; color <= MAX_COLORS; color++)
+	{
+		if (m_colorStart[color + 1] > 0)
+		{
+			m_colorCount = color + 1;
+		}
+		m_colorStart[color + 1] += m_colorStart[color];
+	}
+
+	// places the contacts in color order, keeping the order they were found in within each color
+	m_unsorted.swap(m_contacts);
+	m_contacts.resize(m_unsorted.size());
+	m_next.assign(m_colorStart.begin(), m_colorStart.end() - 1);
+	for (unsigned int i = 0; i < m_unsorted.size(); i++)
+	{
+		m_contacts[m_next[m_contactColors[i]]++] = m_unsorted[i];
+	}
+}
+void ContactSolver::BuildIslands()
+{
+	// joins the bodies that share a contact, the static body is never joined so a floor doesn't join every pile on it together
+	m_islandSets.Reset(m_bodies.size());
+	for (const SolverContact& contact : m_contacts)
+	{
+		if (contact.body1 != 0 && contact.body2 != 0)
+		{
+			m_islandSets.Union(contact.body1, contact.body2);
+		}
+	}
+
+	// numbers the islands in the order their first body was added and counts their bodies
+	m_bodyIslands.assign(m_bodies.size(), NO_SOLVER_ISLAND);
+	m_islandBodies.clear();
+	m_islandCount = 0;
+	for (unsigned int i = 1; i < m_bodies.size(); i++)
+	{
+		unsigned int& island = m_bodyIslands[m_islandSets.Find(i)];
+		if (island == NO_SOLVER_ISLAND)
+		{
+			island = m_islandCount++;
+			m_islandBodies.push_back(0);
+		}
+		m_islandBodies[island]++;
+	}
+
+	// counts the contacts in each island, offset by one so that the counts become the starts of the islands
+	m_islandStart.assign(m_islandCount + 1, 0);
+	m_contactIslands.resize(m_contacts.size());
+	for (unsigned int i = 0; i < m_contacts.size(); i++)
+	{
+		// every contact has at least one body that isn't static
+		const SolverContact& contact = m_contacts[i];
+		unsigned int island = m_bodyIslands[m_islandSets.Find(contact.body1 != 0 ? contact.body1 : contact.body2)];
+		m_contactIslands[i] = island;
+		m_islandStart[island + 1]++;
+	}
+
+	m_largestIsland = 0;
+	m_islandBodyHistogram.clear();
+	m_islandContactHistogram.clear();
+	for (unsigned int island = 0; island < m_islandCount; island++)
+	{
+		unsigned int contactCount = m_islandStart[island + 1];
+		m_largestIsland = std::max(m_largestIsland, contactCount);
+
+		unsigned int bucket = HistogramBucket(m_islandBodies[island]);
+		if (bucket >= m_islandBodyHistogram.size())
+		{
+			m_islandBodyHistogram.resize(bucket + 1, 0);
+		}
+		m_islandBodyHistogram[bucket]++;
+		bucket = HistogramBucket(contactCount);
+		if (bucket >= m_islandContactHistogram.size())
+		{
+			m_islandContactHistogram.resize(bucket + 1, 0);
+		}
+		m_islandContactHistogram[bucket]++;
+
+		m_islandStart[island + 1] += m_islandStart[island];
+	}
+
+	// lists the contacts by island, the contacts are already in color order so each island keeps that order
+	m_islandContacts.resize(m_contacts.size());
+	m_next.assign(m_islandStart.begin(), m_islandStart.end() - 1);
+	for (unsigned int i = 0; i < m_contacts.size(); i++)
+	{
+		m_islandContacts[m_next[m_contactIslands[i]]++] = i;
+	}
+
+	// gives the largest islands out first so the small islands at the end can be stolen to even out the threads
+	m_islandOrder.resize(m_islandCount);
+	for (unsigned int island = 0; island < m_islandCount; island++)
+	{
+		m_islandOrder[island] = island;
+	}
+	// islands of the same size stay in order of their index, std::sort is used because std::stable_sort allocates a buffer
+	std::sort(m_islandOrder.begin(), m_islandOrder.end(), [this](unsigned int a, unsigned int b)
+	{
+		unsigned int size1 = m_islandStart[a + 1] - m_islandStart[a];
+		unsigned int size2 = m_islandStart[b + 1] - m_islandStart[b];
+		return (size1 != size2) ? size1 > size2 : a < b;
+	});
+}
+void ContactSolver::SolveIsland(const unsigned int island)
+{
+	unsigned int begin = m_islandStart[island];
+	unsigned int end = m_islandStart[island + 1];
+
+	if (m_warmStarting)
+	{
+		for (unsigned int i = begin; i < end; i++)
+		{
+			WarmStart(m_contacts[m_islandContacts[i]]);
+		}
+	}
+	for (unsigned int iteration = 0; iteration < m_iterations; iteration++)
+	{
+		for (unsigned int i = begin; i < end; i++)
+		{
+			SolveContact(m_contacts[m_islandContacts[i]]);
+		}
+	}
+	for (unsigned int iteration = 0; iteration < m_positionIterations; iteration++)
+	{
+		for (unsigned int i = begin; i < end; i++)
+		{
+			SolvePosition(m_contacts[m_islandContacts[i]]);
+		}
+	}
+}
+void ContactSolver::RunStage(const Stage stage, WorkerPool * workers)
+{
+	for (unsigned int color = 0; color < m_colorCount; color++)
+	{
+		unsigned int begin = m_colorStart[color];
+		unsigned int end = m_colorStart[color + 1];
+		// the extra color can have contacts that share bodies, so it is always solved on one thread
+		if (workers != nullptr && color < MAX_COLORS && end - begin >= MIN_PARALLEL_CONTACTS)
+		{
+			workers->ParallelFor(end - begin, [&](unsigned int first, unsigned int last, unsigned int /*thread*/)
+			{
+				RunStage(stage, begin + first, begin + last);
+			});
+		}
+		else
+		{
+			RunStage(stage, begin, end);
+		}
+	}
+}
+void ContactSolver::RunStage(const Stage stage, const unsigned int begin, const unsigned int end)
+{
+	switch (stage)
+	{
+	case WARM_START_STAGE:
+		for (unsigned int i = begin; i < end; i++)
+		{
+			WarmStart(m_contacts[i]);
+		}
+		break;
+	case VELOCITY_STAGE:
+		for (unsigned int i = begin; i < end; i++)
+		{
+			SolveContact(m_contacts[i]);
+		}
+		break;
+	case POSITION_STAGE:
+		for (unsigned int i = begin; i < end; i++)
+		{
+			SolvePosition(m_contacts[i]);
+		}
+		break;
+	}
+}
+void ContactSolver::WarmStart(const SolverContact & contact)
+{
+	ApplyImpulse(contact, contact.normal * contact.normalImpulse + contact.tangent * contact.tangentImpulse);
+}
+void ContactSolver::SolveContact(SolverContact & contact)
+{
+	SolverBody& body1 = m_bodies[contact.body1];
+	SolverBody& body2 = m_bodies[contact.body2];
+
+	// the impulse needed to reach the bias speed along the normal
+	glm::vec2 relativeVelocity = body2.velocity - body1.velocity;
+	float lambda = contact.mass * (contact.bias - glm::dot(relativeVelocity, contact.normal));
+	// contacts can only push, so the total impulse can't go below 0
+	float total = fmaxf(contact.normalImpulse + lambda, 0.0f);
+	lambda = total - contact.normalImpulse;
+	contact.normalImpulse = total;
+
+	ApplyImpulse(contact, contact.normal * lambda);
+
+	// the impulse needed to stop the bodies sliding, limited by the friction coefficient and how hard the bodies are pressed together
+	relativeVelocity = body2.velocity - body1.velocity;
+	lambda = -contact.mass * glm::dot(relativeVelocity, contact.tangent);
+	float maxFriction = contact.friction * contact.normalImpulse;
+	total = fmaxf(-maxFriction, fminf(contact.tangentImpulse + lambda, maxFriction));
+	lambda = total - contact.tangentImpulse;
+	contact.tangentImpulse = total;
+
+	ApplyImpulse(contact, contact.tangent * lambda);
+}
+void ContactSolver::SolvePosition(const SolverContact & contact)
+{
+	SolverBody& body1 = m_bodies[contact.body1];
+	SolverBody& body2 = m_bodies[contact.body2];
+
+	// the overlap left after the corrections so far, measured along the normal
+	float overlap = contact.overlap - glm::dot(body2.correction - body1.correction, contact.normal);
+	float correction = fminf(m_baumgarte * (overlap - m_slop), MAX_CORRECTION);
+	if (correction <= 0.0f)
+	{
+		return;
+	}
+
+	// moves each body by the share of the correction that its inverse mass gives it
+	ApplyCorrection(contact, contact.normal * (correction * contact.mass));
+}
+void ContactSolver::ApplyImpulse(const SolverContact & contact, const glm::vec2 & impulse)
+{
+	if (contact.body1 != 0)
+	{
+		m_bodies[contact.body1].velocity -= impulse * m_bodies[contact.body1].inverseMass;
+	}
+	if (contact.body2 != 0)
+	{
+		m_bodies[contact.body2].velocity += impulse * m_bodies[contact.body2].inverseMass;
+	}
+}
+void ContactSolver::ApplyCorrection(const SolverContact & contact, const glm::vec2 & offset)
+{
+	if (contact.body1 != 0)
+	{
+		m_bodies[contact.body1].correction -= offset * m_bodies[contact.body1].inverseMass;
+	}
+	if (contact.body2 != 0)
+	{
+		m_bodies[contact.body2].correction += offset * m_bodies[contact.body2].inverseMass;
+	}
+}
+void ContactSolver::StoreResults()
+{
+	for (const SolverContact& contact : m_contacts)
+	{
+		contact.cached->normalImpulse = contact.normalImpulse;
+		contact.cached->tangentImpulse = contact.tangentImpulse;
+	}
+
+	// skips the shared static body
+	for (unsigned int i = 1; i < m_bodies.size(); i++)
+	{
+		m_bodies[i].body->SetVelocity(m_bodies[i].velocity);
+		if (m_bodies[i].correction != glm::vec2(0.0f, 0.0f))
+		{
+			m_bodies[i].body->SetPosition(m_bodies[i].body->GetPosition() + m_bodies[i].correction);
+		}
+	}
+}
\ No newline at end of file
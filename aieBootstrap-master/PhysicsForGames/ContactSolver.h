@@ -0,0 +1,175 @@
+#pragma once
+
+#include <vector>
+#include "Contact.h"
+#include "ContactCache.h"
+#include "WorkerPool.h"
+#include "UnionFind.h"
+
+class Rigidbody;
+
+// the ways the physics scene can resolve the contacts it finds
+enum SolverType
+{
+	IMMEDIATE = 0, // resolves each contact as soon as it is found, so the result depends on the order of the actors
+	SEQUENTIAL_IMPULSE // finds every contact first and then solves them all together over several iterations
+};
+
+// a rigidbody being moved by the solver, the solver works on a copy of the velocity and writes it back when it is done
+struct SolverBody
+{
+	// null for the shared body used by static objects
+	Rigidbody* body;
+	glm::vec2 velocity;
+	// how far the position iterations have moved the body, added to the position at the end of the step
+	glm::vec2 correction;
+	// 0 for objects that can't be moved by the contacts
+	float inverseMass;
+};
+
+// a contact that has been prepared for the velocity iterations
+struct SolverContact
+{
+	// index of each object in the solver bodies, every static object uses index 0
+	unsigned int body1;
+	unsigned int body2;
+	// from the first body to the second body
+	glm::vec2 normal;
+	// perpendicular to the normal, the direction the friction impulse is applied in
+	glm::vec2 tangent;
+	// the mass that an impulse between the two bodies acts against
+	float mass;
+	// the speed the bodies should separate at along the normal because of the restitution
+	// negative for a speculative contact, the bodies can keep approaching at the speed that just closes the gap
+	float bias;
+	// the overlap when the contact was found, the position iterations subtract the corrections from this
+	float overlap;
+	// the friction coefficient used for the contact
+	float friction;
+	// the total impulses applied this step, kept so that the total can be clamped instead of each iteration's impulse
+	float normalImpulse;
+	float tangentImpulse;
+	// where the impulses are kept for the next step
+	CachedContact* cached;
+};
+
+// resolves all of the contacts found in a step together over several iterations of sequential impulses, warm started from
+// the last step and followed by position iterations, the contacts are colored and joined into islands so they can be split
+// across threads with the same result as solving them on one
+class ContactSolver
+{
+public:
+	ContactSolver();
+	~ContactSolver();
+
+	// solves the contacts and writes the results back to the rigidbodies, split across the workers if a pool is given
+	void Solve(const std::vector<Contact>& contacts, const float timeStep, WorkerPool* workers = nullptr);
+
+	// more iterations give stiffer stacks but cost more time
+	void SetIterations(const unsigned int iterations) { m_iterations = iterations; }
+	unsigned int GetIterations() const { return m_iterations; }
+	void SetPositionIterations(const unsigned int positionIterations) { m_positionIterations = positionIterations; }
+	unsigned int GetPositionIterations() const { return m_positionIterations; }
+	// how much of the remaining overlap each position iteration removes, from 0 to 1
+	void SetBaumgarte(const float baumgarte) { m_baumgarte = baumgarte; }
+	float GetBaumgarte() const { return m_baumgarte; }
+	// the overlap that is left alone so resting contacts stay touching and don't jitter
+	void SetSlop(const float slop) { m_slop = slop; }
+	float GetSlop() const { return m_slop; }
+	// starts each contact from the impulses kept in the cache instead of 0
+	void SetWarmStarting(const bool warmStarting) { m_warmStarting = warmStarting; }
+	bool GetWarmStarting() const { return m_warmStarting; }
+	// the contacts kept between steps, also used to get the hit and miss statistics
+	ContactCache& GetCache() { return m_cache; }
+	// the amount of colors the contacts were sorted into last step, including the colors that no contacts used
+	unsigned int GetColorCount() const { return m_colorCount; }
+	// the amount of islands the contacts were joined into last step
+	unsigned int GetIslandCount() const { return m_islandCount; }
+	// the amount of islands last step with 1, 2 to 3, 4 to 7, 8 to 15 rigidbodies and so on, one bucket per power of 2
+	const std::vector<unsigned int>& GetIslandBodyHistogram() const { return m_islandBodyHistogram; }
+	// the same as the body histogram but counting the contacts in each island
+	const std::vector<unsigned int>& GetIslandContactHistogram() const { return m_islandContactHistogram; }
+	// set if the islands were solved as separate tasks last step instead of splitting the colors
+	bool GetSolvedIslands() const { return m_solvedIslands; }
+
+protected:
+	// the parts of the solve that are run one color at a time
+	enum Stage
+	{
+		WARM_START_STAGE = 0,
+		VELOCITY_STAGE,
+		POSITION_STAGE
+	};
+
+protected:
+	// gets the index of the solver body for the object, adding the rigidbody the first time it is seen
+	unsigned int AddBody(PhysicsObject* obj);
+	// finds the mass, bias and friction of every contact that can be resolved
+	void PrepareContacts(const std::vector<Contact>& contacts, const float timeStep);
+	// sorts the contacts so that the contacts in each color don't share any rigidbodies
+	void ColorContacts();
+	// joins the bodies into islands and lists the contacts in each island, keeping them in color order
+	void BuildIslands();
+	// runs every stage of the solve on the contacts in one island
+	void SolveIsland(const unsigned int island);
+	// runs the stage on every contact one color at a time
+	void RunStage(const Stage stage, WorkerPool* workers);
+	// runs the stage on the contacts from begin up to but not including end
+	void RunStage(const Stage stage, const unsigned int begin, const unsigned int end);
+	// applies the impulses that the contact started with
+	void WarmStart(const SolverContact& contact);
+	// applies the normal and friction impulses for one contact
+	void SolveContact(SolverContact& contact);
+	// moves the bodies in one contact apart by part of the overlap that is left
+	void SolvePosition(const SolverContact& contact);
+	// adds the impulse to the second body and takes it away from the first
+	// the shared static body is never written to, so contacts on different threads can both use it
+	void ApplyImpulse(const SolverContact& contact, const glm::vec2& impulse);
+	// moves the bodies apart along the normal, the same as ApplyImpulse but for the position corrections
+	void ApplyCorrection(const SolverContact& contact, const glm::vec2& offset);
+	// copies the solved velocities and positions back to the rigidbodies and the impulses back to the cache
+	void StoreResults();
+
+protected:
+	// the rigidbodies in the contacts, index 0 is shared by every static object
+	std::vector<SolverBody> m_bodies;
+	// the contacts being solved, sorted by color
+	std::vector<SolverContact> m_contacts;
+	// the contacts before they are sorted
+	std::vector<SolverContact> m_unsorted;
+	// the colors used by the contacts of each body so far, one bit per color
+	std::vector<unsigned long long> m_bodyColors;
+	// the color of each unsorted contact
+	std::vector<unsigned int> m_contactColors;
+	// the index of the first contact in each color, the last color holds the contacts that didn't fit into any of the others
+	std::vector<unsigned int> m_colorStart;
+	unsigned int m_colorCount;
+	// where the next contact goes in each color or island while they are being sorted, kept so it isn't allocated every step
+	std::vector<unsigned int> m_next;
+	// the sets of bodies joined by the contacts, indexed by solver body
+	UnionFind m_islandSets;
+	// the island of each body that represents its set
+	std::vector<unsigned int> m_bodyIslands;
+	// the island of each contact in color order
+	std::vector<unsigned int> m_contactIslands;
+	// the index of each contact in color order, grouped by island
+	std::vector<unsigned int> m_islandContacts;
+	// the index of the first contact of each island in the island contacts
+	std::vector<unsigned int> m_islandStart;
+	// the amount of rigidbodies in each island
+	std::vector<unsigned int> m_islandBodies;
+	// the islands from the most contacts to the fewest, the order they are given to the workers in
+	std::vector<unsigned int> m_islandOrder;
+	std::vector<unsigned int> m_islandBodyHistogram;
+	std::vector<unsigned int> m_islandContactHistogram;
+	unsigned int m_islandCount;
+	// the most contacts in any island
+	unsigned int m_largestIsland;
+	bool m_solvedIslands;
+	unsigned int m_iterations;
+	unsigned int m_positionIterations;
+	float m_baumgarte;
+	float m_slop;
+	bool m_warmStarting;
+	ContactCache m_cache;
+};
\ No newline at end of file
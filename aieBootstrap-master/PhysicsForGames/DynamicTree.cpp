@@ -0,0 +1,258 @@
+#include "DynamicTree.h"
+#include "Rigidbody.h"
+#include <algorithm>
+
+// how much bigger the bounds in the dynamic tree are than the actor, as a fraction of the actor's size
+#define FAT_MARGIN 0.2f
+// the smallest amount the bounds in the dynamic tree are fattened by
+#define MIN_FAT_MARGIN 0.1f
+
+DynamicTree::DynamicTree()
+{
+	m_staticDirty = false;
+}
+DynamicTree::~DynamicTree()
+{
+}
+
+void DynamicTree::FindPairs(const std::vector<PhysicsObject*>& actors, std::vector<CollisionPair>& pairs)
+{
+	pairs.clear();
+	m_unbounded.clear();
+
+	unsigned int actorCount = actors.size();
+	m_bounds.resize(actorCount);
+	m_staticBounds.resize(actorCount);
+	m_proxies.resize(actorCount, { PROXY_NONE, NULL_NODE });
+
+	// updates where each actor is stored
+	for (unsigned int i = 0; i < actorCount; i++)
+	{
+		PhysicsObject* actor = actors[i];
+		TreeProxy& proxy = m_proxies[i];
+		const Bounds& bounds = m_bounds[i] = GetActorBounds(actor);
+
+		// works out which tree the actor belongs in
+		ProxyType type = PROXY_DYNAMIC;
+		if (actor->GetShapeType() == PLANE)
+		{
+			type = PROXY_UNBOUNDED;
+			m_unbounded.push_back(i);
+		}
+		// every shape except planes is a rigidbody
+		// kinematic actors move every step and collide with static actors, so they are stored with the moving actors
+		else if (static_cast<Rigidbody*>(actor)->GetStatic())
+		{
+			type = PROXY_STATIC;
+		}
+
+		if (type != proxy.type)
+		{
+			// removes the actor from its old tree
+			if (proxy.type == PROXY_DYNAMIC)
+			{
+				m_dynamicTree.Remove(proxy.node);
+			}
+			else if (proxy.type == PROXY_STATIC)
+			{
+				m_staticDirty = true;
+			}
+			proxy.type = type;
+			proxy.node = NULL_NODE;
+
+			// adds the actor to its new tree
+			if (type == PROXY_DYNAMIC)
+			{
+				proxy.node = m_dynamicTree.Insert(Fatten(bounds), i);
+			}
+			else if (type == PROXY_STATIC)
+			{
+				m_staticBounds[i] = bounds;
+				m_staticDirty = true;
+			}
+		}
+		else if (type == PROXY_DYNAMIC)
+		{
+			// the actor is only reinserted once it has moved out of its fattened bounds
+			if (!Contains(m_dynamicTree.GetBounds(proxy.node), bounds))
+			{
+				m_dynamicTree.Remove(proxy.node);
+				proxy.node = m_dynamicTree.Insert(Fatten(bounds), i);
+			}
+		}
+		else if (type == PROXY_STATIC)
+		{
+			// static actors can still be moved by setting their position
+			if (bounds.min != m_staticBounds[i].min || bounds.max != m_staticBounds[i].max)
+			{
+				m_staticBounds[i] = bounds;
+				m_staticDirty = true;
+			}
+		}
+	}
+
+	// rebuilds the static tree only when a static actor has changed
+	if (m_staticDirty)
+	{
+		m_staticTree.Clear();
+		for (unsigned int i = 0; i < actorCount; i++)
+		{
+			if (m_proxies[i].type == PROXY_STATIC)
+			{
+				m_proxies[i].node = m_staticTree.Insert(m_staticBounds[i], i);
+			}
+		}
+		m_staticDirty = false;
+	}
+
+	// a search can't find more actors than there are, so the results never grow once there is room for all of them, instead of
+	// growing whenever an actor touches more actors than any before it
+	m_results.reserve(actorCount);
+	// only moving actors need to search the trees, static actors can't collide with each other
+	for (unsigned int i = 0; i < actorCount; i++)
+	{
+		if (m_proxies[i].type != PROXY_DYNAMIC)
+		{
+			continue;
+		}
+
+		// the dynamic tree stores fattened bounds so the actual bounds need to be checked as well
+		// each pair is found by both actors, so it is only added by the actor with the lower index
+		m_results.clear();
+		m_dynamicTree.Query(m_bounds[i], m_results);
+		for (unsigned int other : m_results)
+		{
+			if (other > i && Overlap(m_bounds[i], m_bounds[other]))
+			{
+				pairs.push_back({ i, other });
+			}
+		}
+
+		m_results.clear();
+		m_staticTree.Query(m_bounds[i], m_results);
+		for (unsigned int other : m_results)
+		{
+			pairs.push_back({ std::min(i, other), std::max(i, other) });
+		}
+	}
+
+	// planes are paired with every other actor
+	for (unsigned int plane : m_unbounded)
+	{
+		for (unsigned int i = 0; i < actorCount; i++)
+		{
+			if (m_proxies[i].type != PROXY_UNBOUNDED)
+			{
+				pairs.push_back({ std::min(plane, i), std::max(plane, i) });
+			}
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end(), ComparePairs);
+}
+
+void DynamicTree::OnActorRemoved(const unsigned int index, const unsigned int last)
+{
+	// the actor was added after the last step, so it was never put in a tree
+	if (index >= m_proxies.size())
+	{
+		return;
+	}
+
+	if (m_proxies[index].type == PROXY_DYNAMIC)
+	{
+		m_dynamicTree.Remove(m_proxies[index].node);
+	}
+	else if (m_proxies[index].type == PROXY_STATIC)
+	{
+		m_staticDirty = true;
+	}
+
+	// the moved actor was added after the last step, so the gap is left empty for it to be inserted into on the next step
+	if (last >= m_proxies.size())
+	{
+		m_proxies[index] = { PROXY_NONE, NULL_NODE };
+		return;
+	}
+
+	// moves the last actor's proxy into the gap and points its leaf at the new index
+	m_proxies[index] = m_proxies[last];
+	m_bounds[index] = m_bounds[last];
+	m_staticBounds[index] = m_staticBounds[last];
+	m_proxies.pop_back();
+	m_bounds.pop_back();
+	m_staticBounds.pop_back();
+	if (index < m_proxies.size() && m_proxies[index].node != NULL_NODE)
+	{
+		if (m_proxies[index].type == PROXY_DYNAMIC)
+		{
+			m_dynamicTree.SetIndex(m_proxies[index].node, index);
+		}
+		else if (m_proxies[index].type == PROXY_STATIC)
+		{
+			m_staticTree.SetIndex(m_proxies[index].node, index);
+		}
+	}
+}
+
+void DynamicTree::Query(const Bounds & bounds, std::vector<unsigned int>& results) const
+{
+	// the dynamic tree stores fattened bounds so the actual bounds need to be checked as well
+	// the results are checked where they were added, so the query doesn't need a collection of its own
+	unsigned int kept = results.size();
+	m_dynamicTree.Query(bounds, results);
+	for (unsigned int i = kept; i < results.size(); i++)
+	{
+		if (Overlap(m_bounds[results[i]], bounds))
+		{
+			results[kept++] = results[i];
+		}
+	}
+	results.resize(kept);
+	m_staticTree.Query(bounds, results);
+}
+void DynamicTree::QueryBounds(const Bounds & bounds, std::vector<unsigned int>& results) const
+{
+	Query(bounds, results);
+	for (unsigned int plane : m_unbounded)
+	{
+		if (Overlap(m_bounds[plane], bounds))
+		{
+			results.push_back(plane);
+		}
+	}
+}
+void DynamicTree::QueryRay(const glm::vec2 & start, const glm::vec2 & end, const float radius, std::vector<unsigned int>& results) const
+{
+	// the same as Query, with the fattened bounds of the dynamic tree checked against the actual bounds
+	QuerySegment segment(start, end, radius);
+	unsigned int kept = results.size();
+	m_dynamicTree.QueryRay(segment, results);
+	for (unsigned int i = kept; i < results.size(); i++)
+	{
+		if (segment.Overlaps(m_bounds[results[i]]))
+		{
+			results[kept++] = results[i];
+		}
+	}
+	results.resize(kept);
+	m_staticTree.QueryRay(segment, results);
+	for (unsigned int plane : m_unbounded)
+	{
+		if (segment.Overlaps(m_bounds[plane]))
+		{
+			results.push_back(plane);
+		}
+	}
+}
+
+Bounds DynamicTree::Fatten(const Bounds & bounds)
+{
+	glm::vec2 size = bounds.max - bounds.min;
+	float margin = fmaxf(fmaxf(size.x, size.y) * FAT_MARGIN, MIN_FAT_MARGIN);
+
+	Bounds fattened;
+	fattened.min = bounds.min - glm::vec2(margin, margin);
+	fattened.max = bounds.max + glm::vec2(margin, margin);
+	return fattened;
+}
\ No newline at end of file
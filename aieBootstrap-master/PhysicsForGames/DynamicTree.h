@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Broadphase.h"
+#include "BoundsTree.h"
+
+// where an actor is stored in the dynamic tree broadphase
+enum ProxyType
+{
+	PROXY_NONE = 0, // the actor has not been added yet
+	PROXY_STATIC, // static actors, stored in the static tree
+	PROXY_DYNAMIC, // moving actors including kinematic ones, stored in the dynamic tree
+	PROXY_UNBOUNDED // planes, paired with every other actor
+};
+
+// keeps track of which tree an actor is in
+struct TreeProxy
+{
+	ProxyType type;
+	// the leaf that the actor is stored in
+	int node;
+};
+
+// broadphase that stores static and moving actors in separate bounding volume trees
+// moving actors are stored with fattened bounds so they only need to be reinserted when they leave them
+// the static tree is only rebuilt when a static actor is added, removed or moved, so static level geometry costs almost nothing each step
+class DynamicTree : public Broadphase
+{
+public:
+	DynamicTree();
+	~DynamicTree();
+
+	// updates the trees and fills the collection with the pairs of actors whose bounds overlap
+	virtual void FindPairs(const std::vector<PhysicsObject*>& actors, std::vector<CollisionPair>& pairs);
+	// removes the actor from its tree and moves the last actor's proxy into its place
+	virtual void OnActorRemoved(const unsigned int index, const unsigned int last);
+
+	// adds the index of every actor (excluding planes) whose bounds overlap the given bounds to the collection
+	// uses the bounds from the last call to FindPairs
+	void Query(const Bounds& bounds, std::vector<unsigned int>& results) const;
+	// the same as Query with the planes included
+	virtual void QueryBounds(const Bounds& bounds, std::vector<unsigned int>& results) const;
+	// walks both trees along the segment, only going into the branches it passes through
+	virtual void QueryRay(const glm::vec2& start, const glm::vec2& end, const float radius, std::vector<unsigned int>& results) const;
+
+	const BoundsTree& GetStaticTree() const { return m_staticTree; }
+	const BoundsTree& GetDynamicTree() const { return m_dynamicTree; }
+
+protected:
+	// gets the bounds stored in the dynamic tree, which are bigger than the actor so it can move without being reinserted
+	static Bounds Fatten(const Bounds& bounds);
+
+protected:
+	// static actors
+	BoundsTree m_staticTree;
+	// all other actors that have bounds
+	BoundsTree m_dynamicTree;
+	// where each actor in the scene is stored
+	std::vector<TreeProxy> m_proxies;
+	// the bounds of each actor this step
+	std::vector<Bounds> m_bounds;
+	// the bounds each static actor had when the static tree was built
+	std::vector<Bounds> m_staticBounds;
+	// the indices of the planes in the scene
+	std::vector<unsigned int> m_unbounded;
+	// set when the static tree needs to be rebuilt
+	bool m_staticDirty;
+	// reused to store the results of querying the trees
+	std::vector<unsigned int> m_results;
+};
\ No newline at end of file
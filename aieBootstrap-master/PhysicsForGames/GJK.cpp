@@ -0,0 +1,409 @@
+#include "GJK.h"
+#include <limits>
+#include <algorithm>
+
+// the most iterations each search runs for, curved shapes like circles are only ever approached so the searches need a limit
+#define GJK_MAX_ITERATIONS 32
+#define EPA_MAX_ITERATIONS 32
+#define EPA_MAX_VERTICES (EPA_MAX_ITERATIONS + 3)
+// GJK stops once a new point gets less than this fraction of the squared distance closer to the origin
+#define GJK_TOLERANCE 0.00001f
+// EPA stops once the edge of the difference is found to within this distance
+#define EPA_TOLERANCE 0.0001f
+// the squared distance at which the origin counts as touching the simplex
+#define GJK_EPSILON 0.0000000001f
+
+// a point of the minkowski difference and the points on each shape it is made from
+struct SupportPoint
+{
+	// the point of the second shape minus the point of the first shape
+	glm::vec2 point;
+	glm::vec2 point1;
+	glm::vec2 point2;
+};
+
+// the points GJK has found, a point, line or triangle
+struct Simplex
+{
+	SupportPoint vertices[3];
+	// how much each vertex adds to the point of the simplex closest to the origin
+	float weights[3];
+	unsigned int count;
+};
+
+// gets the point of the difference furthest along the direction
+static SupportPoint Support(const Rigidbody* shape1, const Rigidbody* shape2, const glm::vec2& direction)
+{
+	SupportPoint support;
+	support.point1 = shape1->Support(-direction);
+	support.point2 = shape2->Support(direction);
+	support.point = support.point2 - support.point1;
+	return support;
+}
+
+// the z component of the cross product of two vectors
+static float Cross(const glm::vec2& a, const glm::vec2& b)
+{
+	return a.x * b.y - a.y * b.x;
+}
+
+// finds the point of a line closest to the origin, the vertex is dropped if the closest point is past the end of the line
+static void SolveLine(Simplex& simplex)
+{
+	glm::vec2 a = simplex.vertices[0].point;
+	glm::vec2 b = simplex.vertices[1].point;
+	glm::vec2 edge = b - a;
+
+	// the distances along the edge from each end to the origin
+	float weightA = glm::dot(b, edge);
+	float weightB = -glm::dot(a, edge);
+	if (weightB <= 0.0f)
+	{
+		simplex.weights[0] = 1.0f;
+		simplex.count = 1;
+		return;
+	}
+	if (weightA <= 0.0f)
+	{
+		simplex.vertices[0] = simplex.vertices[1];
+		simplex.weights[0] = 1.0f;
+		simplex.count = 1;
+		return;
+	}
+
+	float inverse = 1.0f / (weightA + weightB);
+	simplex.weights[0] = weightA * inverse;
+	simplex.weights[1] = weightB * inverse;
+}
+
+// finds the part of a triangle closest to the origin, the vertices that aren't part of it are dropped
+// each region of the triangle is tested using the barycentric coordinates of the origin for the edges and the whole triangle
+static void SolveTriangle(Simplex& simplex)
+{
+	glm::vec2 a = simplex.vertices[0].point;
+	glm::vec2 b = simplex.vertices[1].point;
+	glm::vec2 c = simplex.vertices[2].point;
+
+	// the coordinates of the origin for each edge
+	glm::vec2 ab = b - a;
+	float abA = glm::dot(b, ab);
+	float abB = -glm::dot(a, ab);
+	glm::vec2 ac = c - a;
+	float acA = glm::dot(c, ac);
+	float acC = -glm::dot(a, ac);
+	glm::vec2 bc = c - b;
+	float bcB = glm::dot(c, bc);
+	float bcC = -glm::dot(b, bc);
+
+	// the coordinates of the origin for the triangle, the signed areas of the triangles the origin makes with each edge
+	float area = Cross(ab, ac);
+	float abcA = area * Cross(b, c);
+	float abcB = area * Cross(c, a);
+	float abcC = area * Cross(a, b);
+
+	// the regions of each vertex
+	if (abB <= 0.0f && acC <= 0.0f)
+	{
+		simplex.weights[0] = 1.0f;
+		simplex.count = 1;
+		return;
+	}
+	if (abA <= 0.0f && bcC <= 0.0f)
+	{
+		simplex.vertices[0] = simplex.vertices[1];
+		simplex.weights[0] = 1.0f;
+		simplex.count = 1;
+		return;
+	}
+	if (acA <= 0.0f && bcB <= 0.0f)
+	{
+		simplex.vertices[0] = simplex.vertices[2];
+		simplex.weights[0] = 1.0f;
+		simplex.count = 1;
+		return;
+	}
+
+	// the regions of each edge
+	if (abA > 0.0f && abB > 0.0f && abcC <= 0.0f)
+	{
+		float inverse = 1.0f / (abA + abB);
+		simplex.weights[0] = abA * inverse;
+		simplex.weights[1] = abB * inverse;
+		simplex.count = 2;
+		return;
+	}
+	if (acA > 0.0f && acC > 0.0f && abcB <= 0.0f)
+	{
+		float inverse = 1.0f / (acA + acC);
+		simplex.vertices[1] = simplex.vertices[2];
+		simplex.weights[0] = acA * inverse;
+		simplex.weights[1] = acC * inverse;
+		simplex.count = 2;
+		return;
+	}
+	if (bcB > 0.0f && bcC > 0.0f && abcA <= 0.0f)
+	{
+		float inverse = 1.0f / (bcB + bcC);
+		simplex.vertices[0] = simplex.vertices[2];
+		simplex.weights[0] = bcC * inverse;
+		simplex.weights[1] = bcB * inverse;
+		simplex.count = 2;
+		return;
+	}
+
+	// the origin is inside the triangle
+	float inverse = 1.0f / (abcA + abcB + abcC);
+	simplex.weights[0] = abcA * inverse;
+	simplex.weights[1] = abcB * inverse;
+	simplex.weights[2] = abcC * inverse;
+	simplex.count = 3;
+}
+
+// gets the point of the simplex closest to the origin after removing the vertices that aren't needed for it
+static glm::vec2 Solve(Simplex& simplex)
+{
+	if (simplex.count == 2)
+	{
+		SolveLine(simplex);
+	}
+	else if (simplex.count == 3)
+	{
+		SolveTriangle(simplex);
+	}
+	else
+	{
+		simplex.weights[0] = 1.0f;
+	}
+
+	glm::vec2 closest = glm::vec2(0.0f, 0.0f);
+	for (unsigned int i = 0; i < simplex.count; i++)
+	{
+		closest += simplex.vertices[i].point * simplex.weights[i];
+	}
+	return closest;
+}
+
+// runs GJK, returns true if the difference contains the origin
+// the closest point is the point of the simplex closest to the origin, which is the gap between the shapes when they don't overlap
+static bool Search(const Rigidbody* shape1, const Rigidbody* shape2, const glm::vec2& axis, const float maxDistance, Simplex& simplex, glm::vec2& closest)
+{
+	// shapes that were apart last step are usually still apart along the same direction, which only needs one point to show
+	// the axis is only used for that, so the contacts found don't depend on which pairs were checked in the steps before
+	// the gap has to be more than the search below treats as touching, so both always agree that the shapes are apart
+	if (axis != glm::vec2(0.0f, 0.0f))
+	{
+		simplex.vertices[0] = Support(shape1, shape2, -axis);
+		simplex.count = 1;
+		closest = Solve(simplex);
+		float progress = glm::dot(closest, axis);
+		if (progress > 0.0f && progress * progress > fmaxf(maxDistance * maxDistance, GJK_EPSILON) * glm::dot(axis, axis))
+		{
+			closest = axis * (progress / glm::dot(axis, axis));
+			return false;
+		}
+	}
+
+	// the search starts along the line between the shapes
+	glm::vec2 direction = shape2->GetPosition() - shape1->GetPosition();
+	if (direction == glm::vec2(0.0f, 0.0f))
+	{
+		direction = glm::vec2(1.0f, 0.0f);
+	}
+
+	// the first point is the one furthest back along the direction, the closest the difference gets to the origin along it
+	simplex.vertices[0] = Support(shape1, shape2, -direction);
+	simplex.count = 1;
+	closest = Solve(simplex);
+	float progress = glm::dot(closest, direction);
+	if (progress > 0.0f && progress * progress > maxDistance * maxDistance * glm::dot(direction, direction))
+	{
+		closest = direction * (progress / glm::dot(direction, direction));
+		return false;
+	}
+
+	for (unsigned int iteration = 0; iteration < GJK_MAX_ITERATIONS; iteration++)
+	{
+		if (simplex.count == 3)
+		{
+			return true;
+		}
+		float distanceSquared = glm::dot(closest, closest);
+		if (distanceSquared < GJK_EPSILON)
+		{
+			return true;
+		}
+
+		// the point of the difference furthest towards the origin
+		SupportPoint support = Support(shape1, shape2, -closest);
+		// no point of the difference is closer to the origin along the closest direction than the new point
+		// so once it is past the max distance the shapes are known to be at least that far apart
+		float progress = glm::dot(support.point, closest);
+		if (progress > 0.0f && progress * progress > maxDistance * maxDistance * distanceSquared)
+		{
+			return false;
+		}
+		// the new point is barely closer than the simplex, so the simplex already has the closest point
+		if (distanceSquared - progress <= GJK_TOLERANCE * distanceSquared)
+		{
+			return false;
+		}
+		// a point that is already in the simplex means the search is going round in circles
+		for (unsigned int i = 0; i < simplex.count; i++)
+		{
+			if (support.point == simplex.vertices[i].point)
+			{
+				return false;
+			}
+		}
+
+		simplex.vertices[simplex.count] = support;
+		simplex.count++;
+		closest = Solve(simplex);
+	}
+
+	return false;
+}
+
+// turns the simplex GJK finished with into a triangle, GJK can stop with a point or line if the origin is on it
+// returns false if the difference has no area
+static bool CompleteTriangle(const Rigidbody* shape1, const Rigidbody* shape2, Simplex& simplex)
+{
+	if (simplex.count == 1)
+	{
+		glm::vec2 direction = -simplex.vertices[0].point;
+		if (glm::dot(direction, direction) < GJK_EPSILON)
+		{
+			direction = glm::vec2(1.0f, 0.0f);
+		}
+		simplex.vertices[1] = Support(shape1, shape2, direction);
+		if (simplex.vertices[1].point == simplex.vertices[0].point)
+		{
+			simplex.vertices[1] = Support(shape1, shape2, -direction);
+		}
+		simplex.count = 2;
+	}
+	if (simplex.count == 2)
+	{
+		glm::vec2 edge = simplex.vertices[1].point - simplex.vertices[0].point;
+		glm::vec2 normal = glm::vec2(-edge.y, edge.x);
+		simplex.vertices[2] = Support(shape1, shape2, normal);
+		// the difference might not reach past the line on that side if the line is one of its edges
+		if (glm::dot(simplex.vertices[2].point - simplex.vertices[0].point, normal) < GJK_EPSILON)
+		{
+			simplex.vertices[2] = Support(shape1, shape2, -normal);
+		}
+		simplex.count = 3;
+	}
+
+	float area = Cross(simplex.vertices[1].point - simplex.vertices[0].point, simplex.vertices[2].point - simplex.vertices[0].point);
+	return fabsf(area) > GJK_EPSILON;
+}
+
+bool GJK::Collide(Rigidbody * shape1, Rigidbody * shape2, glm::vec2 & axis, Contact & contact)
+{
+	Simplex simplex;
+	glm::vec2 closest;
+	if (!Search(shape1, shape2, axis, 0.0f, simplex, closest))
+	{
+		// the direction to the closest point separates the shapes
+		axis = closest;
+		return false;
+	}
+	if (!CompleteTriangle(shape1, shape2, simplex))
+	{
+		return false;
+	}
+
+	// the polytope is kept counter clockwise so the outside of each edge is on its right
+	SupportPoint polytope[EPA_MAX_VERTICES];
+	unsigned int count = 3;
+	polytope[0] = simplex.vertices[0];
+	polytope[1] = simplex.vertices[1];
+	polytope[2] = simplex.vertices[2];
+	if (Cross(polytope[1].point - polytope[0].point, polytope[2].point - polytope[0].point) < 0.0f)
+	{
+		std::swap(polytope[1], polytope[2]);
+	}
+
+	unsigned int closestEdge = 0;
+	glm::vec2 normal = glm::vec2(0.0f, 0.0f);
+	float depth = 0.0f;
+	for (unsigned int iteration = 0; iteration <= EPA_MAX_ITERATIONS; iteration++)
+	{
+		// finds the edge closest to the origin
+		depth = std::numeric_limits<float>::max();
+		for (unsigned int i = 0; i < count; i++)
+		{
+			glm::vec2 edge = polytope[(i + 1 == count) ? 0 : i + 1].point - polytope[i].point;
+			float length = glm::length(edge);
+			if (length == 0.0f)
+			{
+				continue;
+			}
+			glm::vec2 edgeNormal = glm::vec2(edge.y, -edge.x) / length;
+			float distance = glm::dot(edgeNormal, polytope[i].point);
+			if (distance < depth)
+			{
+				depth = distance;
+				normal = edgeNormal;
+				closestEdge = i;
+			}
+		}
+
+		// if the difference doesn't reach past the edge then the edge is on the outside of the difference
+		SupportPoint support = Support(shape1, shape2, normal);
+		if (glm::dot(support.point, normal) - depth < EPA_TOLERANCE || count == EPA_MAX_VERTICES)
+		{
+			break;
+		}
+
+		// puts the new point between the ends of the edge
+		for (unsigned int i = count; i > closestEdge + 1; i--)
+		{
+			polytope[i] = polytope[i - 1];
+		}
+		polytope[closestEdge + 1] = support;
+		count++;
+	}
+
+	// the point on the edge closest to the origin gives the deepest point of each shape
+	const SupportPoint& start = polytope[closestEdge];
+	const SupportPoint& end = polytope[(closestEdge + 1 == count) ? 0 : closestEdge + 1];
+	glm::vec2 edge = end.point - start.point;
+	float t = glm::clamp(-glm::dot(start.point, edge) / glm::dot(edge, edge), 0.0f, 1.0f);
+	glm::vec2 point1 = start.point1 + (end.point1 - start.point1) * t;
+	glm::vec2 point2 = start.point2 + (end.point2 - start.point2) * t;
+
+	// the second shape is pushed out by moving the difference back past the edge, so the normal is the opposite of the edge's
+	contact.object1 = shape1;
+	contact.object2 = shape2;
+	contact.normal = -normal;
+	contact.overlap = depth;
+	contact.point = (point1 + point2) * 0.5f;
+	axis = contact.normal;
+	return true;
+}
+
+bool GJK::Distance(const Rigidbody * shape1, const Rigidbody * shape2, glm::vec2 & axis, const float maxDistance, ConvexDistance & result)
+{
+	Simplex simplex;
+	glm::vec2 closest;
+	if (Search(shape1, shape2, axis, maxDistance, simplex, closest))
+	{
+		result.distance = 0.0f;
+		return false;
+	}
+
+	// the closest points of the shapes are made from the vertices in the same amounts as the closest point of the simplex
+	result.point1 = glm::vec2(0.0f, 0.0f);
+	result.point2 = glm::vec2(0.0f, 0.0f);
+	for (unsigned int i = 0; i < simplex.count; i++)
+	{
+		result.point1 += simplex.vertices[i].point1 * simplex.weights[i];
+		result.point2 += simplex.vertices[i].point2 * simplex.weights[i];
+	}
+	result.distance = glm::length(closest);
+	result.normal = closest / result.distance;
+	axis = result.normal;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Rigidbody.h"
+#include "Contact.h"
+
+// the result of a distance query between two convex shapes
+struct ConvexDistance
+{
+	// the closest point on each shape
+	glm::vec2 point1;
+	glm::vec2 point2;
+	// the direction from the first shape to the second
+	glm::vec2 normal;
+	// the distance between the closest points, 0 if the shapes overlap
+	float distance;
+};
+
+// collision between any two convex shapes using only the support functions of the shapes
+// GJK searches the minkowski difference of the shapes (every point of the second shape minus every point of the first) for the
+// point closest to the origin, the shapes overlap if the difference contains the origin
+// when they overlap EPA expands the last GJK triangle out to the edge of the difference closest to the origin, which gives
+// the normal and depth of the overlap
+// both take the axis they finished with last step and replace it with the direction from the first shape to the second that they
+// finish with, shapes still apart along the axis are found from one point and everything else is searched from the start
+class GJK
+{
+public:
+	// checks if the shapes overlap and fills in the contact if they do
+	static bool Collide(Rigidbody* shape1, Rigidbody* shape2, glm::vec2& axis, Contact& contact);
+	// finds the closest points of the shapes, returns false if they overlap
+	// the search stops once the shapes are known to be further apart than the max distance, the distance is then only a lower bound
+	static bool Distance(const Rigidbody* shape1, const Rigidbody* shape2, glm::vec2& axis, const float maxDistance, ConvexDistance& result);
+};
\ No newline at end of file
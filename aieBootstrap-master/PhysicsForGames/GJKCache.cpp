@@ -0,0 +1,61 @@
+#include "GJKCache.h"
+
+GJKCache::GJKCache()
+{
+	m_step = 0;
+	m_hits = 0;
+	m_misses = 0;
+}
+GJKCache::~GJKCache()
+{
+}
+
+void GJKCache::BeginStep()
+{
+	m_step++;
+}
+void GJKCache::EndStep()
+{
+	for (auto it = m_axes.begin(); it != m_axes.end();)
+	{
+		if (it->second.step != m_step)
+		{
+			it = m_axes.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+}
+
+glm::vec2 GJKCache::Find(const ContactKey & key) const
+{
+	// the pairs that weren't checked last step were removed, so any pair found was checked last step
+	auto it = m_axes.find(key);
+	if (it == m_axes.end())
+	{
+		return glm::vec2(0.0f, 0.0f);
+	}
+	return it->second.axis;
+}
+void GJKCache::Store(const ContactKey & key, const glm::vec2 & axis)
+{
+	// searches before inserting because emplace allocates a node even when the pair is already there
+	auto it = m_axes.find(key);
+	if (it != m_axes.end())
+	{
+		m_hits++;
+	}
+	else
+	{
+		m_misses++;
+		it = m_axes.emplace(key, CachedAxis()).first;
+	}
+	it->second.axis = axis;
+	it->second.step = m_step;
+}
+void GJKCache::Clear()
+{
+	m_axes.clear();
+}
\ No newline at end of file
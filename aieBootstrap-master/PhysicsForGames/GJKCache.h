@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ContactCache.h"
+
+// the direction GJK finished with for a pair and the step the pair was last checked in
+struct CachedAxis
+{
+	glm::vec2 axis;
+	unsigned int step;
+};
+
+// a direction waiting to be stored, used while the cache can't be changed
+struct PairAxis
+{
+	ContactKey key;
+	glm::vec2 axis;
+};
+
+// keeps the direction GJK finished searching in for each pair of shapes it is used on, so pairs still apart along it next step
+// are found without a search
+// the pairs checked on several threads can only read the cache, so their directions are stored once every pair has been checked
+class GJKCache
+{
+public:
+	GJKCache();
+	~GJKCache();
+
+	// starts a new step, the directions stored after this are marked as checked this step
+	void BeginStep();
+	// removes the pairs that weren't checked this step
+	void EndStep();
+	// gets the direction the pair finished with last step, zero if the pair wasn't checked then
+	glm::vec2 Find(const ContactKey& key) const;
+	void Store(const ContactKey& key, const glm::vec2& axis);
+	void Clear();
+
+	// the amount of pairs that started from the direction of the last step
+	unsigned int GetHits() const { return m_hits; }
+	// the amount of pairs that started without a direction
+	unsigned int GetMisses() const { return m_misses; }
+	void ResetStatistics() { m_hits = 0; m_misses = 0; }
+	// the amount of pairs being kept
+	unsigned int GetCount() const { return m_axes.size(); }
+
+protected:
+	// the nodes come from a pool because pairs start and stop being checked as the broadphase changes
+	std::unordered_map<ContactKey, CachedAxis, ContactKeyHash, std::equal_to<ContactKey>,
+		PoolAllocator<std::pair<const ContactKey, CachedAxis>>> m_axes;
+	// incremented at the start of each step
+	unsigned int m_step;
+	unsigned int m_hits;
+	unsigned int m_misses;
+};
\ No newline at end of file
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <new>
+
+// the amount of objects allocated together each time a pool runs out
+#define POOL_CHUNK_SIZE 256
+
+// hands out memory for objects of one type from large chunks, so spawning and removing objects doesn't go to the heap each time
+// the memory of a deleted object is put in a free list and given to the next object that is created
+// the shapes use it from their own operator new and delete, so they are still created with new and destroyed with delete
+template<typename T>
+class ObjectPool
+{
+public:
+	ObjectPool()
+	{
+		m_free = nullptr;
+		m_count = 0;
+	}
+	~ObjectPool()
+	{
+		for (Slot* chunk : m_chunks)
+		{
+			::operator delete(chunk);
+		}
+	}
+
+	// gets memory for one object, a class derived from T is bigger than a slot so it is given memory from the heap instead
+	void* Allocate(const size_t size)
+	{
+		if (size != sizeof(T))
+		{
+			return ::operator new(size);
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_free == nullptr)
+		{
+			AddChunk();
+		}
+		Slot* slot = m_free;
+		m_free = slot->next;
+		m_count++;
+		return slot;
+	}
+	// puts the memory back in the free list
+	void Deallocate(void* memory, const size_t size)
+	{
+		if (size != sizeof(T))
+		{
+			::operator delete(memory);
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		Slot* slot = static_cast<Slot*>(memory);
+		slot->next = m_free;
+		m_free = slot;
+		m_count--;
+	}
+
+	// the amount of objects using the pool
+	unsigned int GetCount() const { return m_count; }
+	// the amount of objects the chunks have room for
+	unsigned int GetCapacity() const { return m_chunks.size() * POOL_CHUNK_SIZE; }
+
+	// the pool shared by every object of the type
+	static ObjectPool& Get()
+	{
+		static ObjectPool pool;
+		return pool;
+	}
+
+protected:
+	// holds an object while it is being used and the next free slot while it isn't
+	union Slot
+	{
+		Slot* next;
+		alignas(T) unsigned char object[sizeof(T)];
+	};
+
+protected:
+	// adds a chunk of free slots, linked so that they are handed out in order
+	void AddChunk()
+	{
+		Slot* chunk = static_cast<Slot*>(::operator new(sizeof(Slot) * POOL_CHUNK_SIZE));
+		m_chunks.push_back(chunk);
+		for (int i = POOL_CHUNK_SIZE - 1; i >= 0; i--)
+		{
+			chunk[i].next = m_free;
+			m_free = &chunk[i];
+		}
+	}
+
+protected:
+	std::mutex m_mutex;
+	std::vector<Slot*> m_chunks;
+	// the first free slot
+	Slot* m_free;
+	unsigned int m_count;
+};
+
+// an allocator that takes single objects from the object pool for the type, used by node based containers like
+// std::unordered_map so that inserting and erasing elements every step doesn't go to the heap
+// arrays such as the buckets still come from the heap, they only grow when the container does
+template<typename T>
+class PoolAllocator
+{
+public:
+	typedef T value_type;
+
+	PoolAllocator() {}
+	template<typename U>
+	PoolAllocator(const PoolAllocator<U>& /*other*/) {}
+
+	T* allocate(const size_t count)
+	{
+		if (count == 1)
+		{
+			return static_cast<T*>(ObjectPool<T>::Get().Allocate(sizeof(T)));
+		}
+		return static_cast<T*>(::operator new(count * sizeof(T)));
+	}
+	void deallocate(T* memory, const size_t count)
+	{
+		if (count == 1)
+		{
+			ObjectPool<T>::Get().Deallocate(memory, sizeof(T));
+			return;
+		}
+		::operator delete(memory);
+	}
+
+	// every allocator of the type uses the same pool, so memory from one can be freed by another
+	template<typename U>
+	bool operator==(const PoolAllocator<U>& /*other*/) const { return true; }
+	template<typename U>
+	bool operator!=(const PoolAllocator<U>& /*other*/) const { return false; }
+};
\ No newline at end of file
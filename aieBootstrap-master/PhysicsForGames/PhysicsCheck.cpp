@@ -0,0 +1,454 @@
+#include "PhysicsCheck.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <cstring>
+#include <glm/ext.hpp>
+#include "Plane.h"
+#include "Sphere.h"
+#include "AABB.h"
+#include "Poly.h"
+#include "SphereBatch.h"
+#include "AllocationCounter.h"
+
+// the steps run before the hashes are taken
+#define CHECK_HASH_STEPS 120
+// the steps run before the allocations are counted, the immediate solver takes a while for the pile to settle into the
+// largest amount of contacts it will have
+#define CHECK_WARM_UP_STEPS 300
+// the steps the allocations are counted over
+#define CHECK_ALLOCATION_STEPS 60
+// the amount of poly to poly tests timed for each amount of sides
+#define CHECK_POLY_TESTS 100000
+// the actors in the mixed scene that every pair of is checked, and the amount of times they are checked
+#define CHECK_NARROWPHASE_ACTORS 2000
+#define CHECK_NARROWPHASE_PASSES 5
+// the circle pairs in the timed sphere batch, too many to fit in the cache, and the times the batch is filtered
+#define CHECK_SPHERE_PAIRS 1000000
+#define CHECK_SPHERE_FILTERS 20
+// the steps the body store is compared with FixedUpdate over
+#define CHECK_INTEGRATOR_STEPS 200
+// the amount of bodies integrated for each timing, split into as many steps as the amount of bodies needs
+#define CHECK_INTEGRATOR_UPDATES 20000000
+
+static const SolverType CHECK_SOLVERS[] = { IMMEDIATE, SEQUENTIAL_IMPULSE };
+static const BroadphaseType CHECK_BROADPHASES[] = { BRUTE_FORCE, UNIFORM_GRID, SWEEP_AND_PRUNE, DYNAMIC_TREE };
+static const SimdLevel CHECK_SIMD_LEVELS[] = { SIMD_NONE, SIMD_SSE2, SIMD_AVX2 };
+
+// mt19937 gives the same numbers everywhere but the standard distributions don't, so the scenes are made from the raw numbers
+// to keep the hashes the same between compilers
+static float RandomRange(std::mt19937& random, const float min, const float max)
+{
+	return min + (max - min) * (float)(random() / 4294967295.0);
+}
+
+// compares the bits rather than the values so -0 and 0 are told apart
+static bool SameBits(const float a, const float b)
+{
+	return memcmp(&a, &b, sizeof(float)) == 0;
+}
+
+int PhysicsCheck::Run()
+{
+	bool passed = CheckHashes();
+	passed = CheckAllocations() && passed;
+	passed = CheckIntegrator() && passed;
+	TimePolyPairs();
+	TimeNarrowphase();
+	TimeSphereBatch();
+	TimeIntegrator();
+
+	std::cout << (passed ? "check passed" : "check FAILED") << std::endl;
+	return passed ? 0 : 1;
+}
+
+std::vector<Rigidbody*> PhysicsCheck::MakeMixedScene(PhysicsScene& scene, const unsigned int count, const unsigned int seed)
+{
+	std::mt19937 random(seed);
+	float extent = 100.0f;
+	scene.SetGravity(glm::vec2(0.0f, -10.0f));
+	scene.SetTimeStep(0.01f);
+	scene.AddActor(new Plane({ 0.0f, 1.0f }, -extent - 10.0f));
+	scene.AddActor(new Plane({ 0.0f, -1.0f }, -extent - 10.0f));
+	scene.AddActor(new Plane({ 1.0f, 0.0f }, -extent - 10.0f));
+	scene.AddActor(new Plane({ -1.0f, 0.0f }, -extent - 10.0f));
+
+	std::vector<Rigidbody*> bodies;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		glm::vec2 position(RandomRange(random, -extent, extent), RandomRange(random, -extent, extent));
+		glm::vec2 velocity(RandomRange(random, -20.0f, 20.0f), RandomRange(random, -20.0f, 20.0f));
+		float size = RandomRange(random, 1.0f, 3.0f);
+		// one in ten are static so the broadphases have static actors to keep apart
+		bool staticRigidbody = (random() % 10) == 0;
+		Rigidbody* body;
+		switch (random() % 3)
+		{
+		case 0:
+			body = new AABB(position, velocity, size * 2.0f, size * 2.0f, 2.0f, { 1.0f, 1.0f, 1.0f, 1.0f }, false, staticRigidbody, 0.8f, 0.0f, 0.0f, 0.3f, 0.2f);
+			break;
+		case 1:
+			body = new Sphere(position, velocity, size, 2.0f, { 1.0f, 1.0f, 1.0f, 1.0f }, false, staticRigidbody, 0.8f, 0.0f, 0.0f, 0.3f, 0.2f);
+			break;
+		default:
+			body = new Poly(position, { { -size, -size }, { size, -size }, { size * 1.2f, size * 0.5f }, { 0.0f, size }, { -size, size * 0.3f } },
+				velocity, 3.0f, { 1.0f, 1.0f, 1.0f, 1.0f }, false, staticRigidbody);
+			break;
+		}
+		scene.AddActor(body);
+		bodies.push_back(body);
+	}
+	return bodies;
+}
+
+void PhysicsCheck::MakePileScene(PhysicsScene& scene, const ShapeType shape)
+{
+	scene.SetGravity(glm::vec2(0.0f, -10.0f));
+	scene.SetTimeStep(1.0f / 60.0f);
+	scene.AddActor(new Plane({ 0.0f, 1.0f }, 0.0f));
+	for (int y = 0; y < 10; y++)
+	{
+		for (int x = 0; x < 20; x++)
+		{
+			glm::vec2 position(x * 2.5f, 1.0f + y * 2.01f);
+			if (shape == SPHERE)
+			{
+				scene.AddActor(new Sphere(position, { 0.0f, 0.0f }, 1.0f, 1.0f, { 1.0f, 1.0f, 1.0f, 1.0f }, false, false, 0.1f));
+			}
+			else
+			{
+				scene.AddActor(new AABB(position, { 0.0f, 0.0f }, 2.0f, 2.0f, 1.0f, { 1.0f, 1.0f, 1.0f, 1.0f }, false, false, 0.1f));
+			}
+		}
+	}
+}
+
+double PhysicsCheck::HashBodies(const std::vector<Rigidbody*>& bodies)
+{
+	double hash = 0.0;
+	for (unsigned int i = 0; i < bodies.size(); i++)
+	{
+		double weight = i + 1;
+		hash += weight * bodies[i]->GetPosition().x + ((i + 1) * 7 % 13) * (double)bodies[i]->GetPosition().y + 0.5 * bodies[i]->GetVelocity().x;
+	}
+	return hash;
+}
+
+std::vector<Rigidbody*> PhysicsCheck::MakeIntegratorBodies(const unsigned int count, const unsigned int seed)
+{
+	std::mt19937 random(seed);
+	std::vector<Rigidbody*> bodies;
+	bodies.reserve(count);
+	for (unsigned int i = 0; i < count; i++)
+	{
+		glm::vec2 position(RandomRange(random, -100.0f, 100.0f), RandomRange(random, -100.0f, 100.0f));
+		// one in four are slow enough for the thresholds to stop them
+		float speed = (random() % 4) == 0 ? 0.0002f : 20.0f;
+		glm::vec2 velocity(RandomRange(random, -speed, speed), RandomRange(random, -speed, speed));
+		unsigned int type = random() % 10;
+		Rigidbody* body = new Sphere(position, velocity, 1.0f, RandomRange(random, 0.5f, 5.0f), { 1.0f, 1.0f, 1.0f, 1.0f }, type == 0, type == 1,
+			1.0f, RandomRange(random, 0.0f, 2.0f), RandomRange(random, 0.0f, 2.0f));
+		body->SetRotation(RandomRange(random, -glm::pi<float>(), glm::pi<float>()));
+		body->SetAngularVelocity((random() % 4) == 0 ? RandomRange(random, -0.00002f, 0.00002f) : RandomRange(random, -5.0f, 5.0f));
+		bodies.push_back(body);
+	}
+	return bodies;
+}
+
+bool PhysicsCheck::CheckHashes()
+{
+	const unsigned int threadCounts[] = { 1, 2, 4 };
+	bool passed = true;
+	std::cout << std::fixed << std::setprecision(6);
+	for (SolverType solver : CHECK_SOLVERS)
+	{
+		double hashes[4][3];
+		for (unsigned int broadphase = 0; broadphase < 4; broadphase++)
+		{
+			for (unsigned int i = 0; i < 3; i++)
+			{
+				PhysicsScene scene;
+				std::vector<Rigidbody*> bodies = MakeMixedScene(scene, 400, 7);
+				scene.SetSolver(solver);
+				scene.SetBroadphase(CHECK_BROADPHASES[broadphase]);
+				scene.SetThreadCount(threadCounts[i]);
+				for (int step = 0; step < CHECK_HASH_STEPS; step++)
+				{
+					scene.Update(scene.GetTimeStep());
+				}
+				hashes[broadphase][i] = HashBodies(bodies);
+				std::cout << "hash solver " << solver << " broadphase " << broadphase << " threads " << threadCounts[i] << ": " << hashes[broadphase][i] << std::endl;
+			}
+		}
+
+		// the result can't depend on the broadphase or the amount of threads, except that the immediate solver resolves each
+		// contact as soon as it is found on 1 thread, where the brute force loop finds the later pairs after the earlier ones moved
+		for (unsigned int broadphase = 0; broadphase < 4; broadphase++)
+		{
+			for (unsigned int i = 0; i < 3; i++)
+			{
+				bool immediate = solver == IMMEDIATE && threadCounts[i] == 1;
+				double expected = immediate ? hashes[UNIFORM_GRID][i] : hashes[BRUTE_FORCE][2];
+				if ((!immediate || broadphase != BRUTE_FORCE) && hashes[broadphase][i] != expected)
+				{
+					std::cout << "hash solver " << solver << " broadphase " << broadphase << " threads " << threadCounts[i] << ": doesn't match" << std::endl;
+					passed = false;
+				}
+			}
+		}
+	}
+	return passed;
+}
+
+bool PhysicsCheck::CheckAllocations()
+{
+#ifndef PHYSICS_ALLOCATION_COUNTER
+	std::cout << "allocations: skipped, PHYSICS_ALLOCATION_COUNTER isn't defined" << std::endl;
+	return true;
+#else
+	const ShapeType scenes[] = { SPHERE, BOX, POLY };
+	const unsigned int threadCounts[] = { 1, 4 };
+	bool passed = true;
+	for (ShapeType shape : scenes)
+	{
+		for (SolverType solver : CHECK_SOLVERS)
+		{
+			for (BroadphaseType broadphase : CHECK_BROADPHASES)
+			{
+				for (unsigned int threadCount : threadCounts)
+				{
+					PhysicsScene scene;
+					// the poly scene is the mixed scene, which has every type of shape
+					if (shape == POLY)
+					{
+						MakeMixedScene(scene, 200, 3);
+					}
+					else
+					{
+						MakePileScene(scene, shape);
+					}
+					scene.SetSolver(solver);
+					scene.SetBroadphase(broadphase);
+					// the body store is only used by some of the runs so both ways of integrating are checked
+					scene.SetBodyStorage(broadphase == UNIFORM_GRID || broadphase == DYNAMIC_TREE);
+					scene.SetThreadCount(threadCount);
+					for (int step = 0; step < CHECK_WARM_UP_STEPS; step++)
+					{
+						scene.Update(scene.GetTimeStep());
+					}
+					unsigned long long allocations = 0;
+					for (int step = 0; step < CHECK_ALLOCATION_STEPS; step++)
+					{
+						scene.Update(scene.GetTimeStep());
+						allocations += scene.GetStepAllocations();
+					}
+					std::cout << "allocations scene " << shape << " solver " << solver << " broadphase " << broadphase << " threads " << threadCount
+						<< ": " << allocations << std::endl;
+					passed = passed && allocations == 0;
+				}
+			}
+		}
+	}
+	return passed;
+#endif
+}
+
+bool PhysicsCheck::CheckIntegrator()
+{
+	bool passed = true;
+	for (SimdLevel simdLevel : CHECK_SIMD_LEVELS)
+	{
+		BodyStore store;
+		store.SetSimdLevel(simdLevel);
+		if (store.GetSimdLevel() != simdLevel)
+		{
+			std::cout << "integrator simd " << simdLevel << ": skipped, the cpu doesn't support it" << std::endl;
+			continue;
+		}
+
+		// an odd amount so the simd paths leave some bodies for the scalar loop
+		std::vector<Rigidbody*> bodies = MakeIntegratorBodies(1001, 5);
+		std::vector<Rigidbody*> storedBodies = MakeIntegratorBodies(1001, 5);
+		for (Rigidbody* body : storedBodies)
+		{
+			body->AttachToStore(&store);
+		}
+		// without gravity the slow bodies get stopped by the thresholds, with it the drag is tested against larger velocities
+		for (int step = 0; step < CHECK_INTEGRATOR_STEPS; step++)
+		{
+			glm::vec2 gravity = step < CHECK_INTEGRATOR_STEPS / 2 ? glm::vec2(0.0f, 0.0f) : glm::vec2(0.0f, -10.0f);
+			for (Rigidbody* body : bodies)
+			{
+				body->FixedUpdate(gravity, 0.01f);
+			}
+			store.Integrate(gravity, 0.01f);
+		}
+
+		unsigned int mismatches = 0;
+		for (unsigned int i = 0; i < bodies.size(); i++)
+		{
+			storedBodies[i]->DetachFromStore();
+			if (!SameBits(bodies[i]->GetPosition().x, storedBodies[i]->GetPosition().x) || !SameBits(bodies[i]->GetPosition().y, storedBodies[i]->GetPosition().y) ||
+				!SameBits(bodies[i]->GetVelocity().x, storedBodies[i]->GetVelocity().x) || !SameBits(bodies[i]->GetVelocity().y, storedBodies[i]->GetVelocity().y) ||
+				!SameBits(bodies[i]->GetRotation(), storedBodies[i]->GetRotation()) || !SameBits(bodies[i]->GetAngularVelocity(), storedBodies[i]->GetAngularVelocity()))
+			{
+				mismatches++;
+			}
+			delete bodies[i];
+			delete storedBodies[i];
+		}
+		std::cout << "integrator simd " << simdLevel << ": " << mismatches << " bodies don't match FixedUpdate" << std::endl;
+		passed = passed && mismatches == 0;
+	}
+	return passed;
+}
+
+void PhysicsCheck::TimePolyPairs()
+{
+	const int sideCounts[] = { 4, 8, 16, 32 };
+	for (int sides : sideCounts)
+	{
+		std::vector<glm::vec2> vertices;
+		for (int i = 0; i < sides; i++)
+		{
+			float angle = (2 * glm::pi<float>()) * i / sides;
+			vertices.push_back({ cosf(angle), sinf(angle) });
+		}
+		Poly poly1({ 10.0f, 20.0f }, vertices, { 0.0f, 0.0f }, 1.0f);
+		Poly poly2({ 11.7f, 20.3f }, vertices, { 0.0f, 0.0f }, 1.0f);
+
+		Contact contact;
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < CHECK_POLY_TESTS; i++)
+		{
+			PhysicsScene::Poly2Poly(&poly1, &poly2, contact);
+			// the contact points come from the step arena, which is normally reset by the scene at the end of each update
+			if ((i & 1023) == 0)
+			{
+				StepArena::GetThreadArena().Reset();
+			}
+		}
+		StepArena::GetThreadArena().Reset();
+		double nanoseconds = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CHECK_POLY_TESTS;
+		std::cout << std::setprecision(1) << "poly to poly sides " << sides << ": " << nanoseconds << " ns per test" << std::setprecision(6) << std::endl;
+	}
+}
+
+void PhysicsCheck::TimeNarrowphase()
+{
+	// without a broadphase every pair is passed to the collision functions, so this mostly times picking the function and
+	// rejecting the pairs that are apart
+	PhysicsScene scene;
+	MakeMixedScene(scene, CHECK_NARROWPHASE_ACTORS, 13);
+	scene.SetBroadphase(BRUTE_FORCE);
+	// the sequential impulse solver only changes the velocities, so every pass checks the same positions
+	scene.SetSolver(SEQUENTIAL_IMPULSE);
+	// the 4 planes are actors too
+	unsigned int pairs = (CHECK_NARROWPHASE_ACTORS + 4) * (CHECK_NARROWPHASE_ACTORS + 3) / 2;
+
+	double best = 0.0;
+	for (int pass = 0; pass < CHECK_NARROWPHASE_PASSES; pass++)
+	{
+		auto start = std::chrono::steady_clock::now();
+		scene.CheckForCollision();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		best = (pass == 0) ? seconds : std::min(best, seconds);
+		// the contacts come from the step arena, which is normally reset by the scene at the end of each update
+		StepArena::GetThreadArena().Reset();
+	}
+	std::cout << std::setprecision(1) << "narrowphase pairs " << pairs << ": " << best * 1000.0 << " ms, " << best * 1000000000.0 / pairs
+		<< " ns per pair" << std::setprecision(6) << std::endl;
+}
+
+void PhysicsCheck::TimeSphereBatch()
+{
+	// the second circle is up to 1 away on each axis and the radii add up to 0.5, so about a fifth of the pairs overlap
+	std::mt19937 random(11);
+	SphereBatch batch;
+	for (unsigned int i = 0; i < CHECK_SPHERE_PAIRS; i++)
+	{
+		glm::vec2 position(RandomRange(random, -100.0f, 100.0f), RandomRange(random, -100.0f, 100.0f));
+		batch.Add(i, position, position + glm::vec2(RandomRange(random, -1.0f, 1.0f), RandomRange(random, -1.0f, 1.0f)), 0.5f);
+	}
+
+	std::cout << std::setprecision(1);
+	for (SimdLevel simdLevel : CHECK_SIMD_LEVELS)
+	{
+		batch.SetSimdLevel(simdLevel);
+		if (batch.GetSimdLevel() != simdLevel)
+		{
+			continue;
+		}
+		auto start = std::chrono::steady_clock::now();
+		for (int filter = 0; filter < CHECK_SPHERE_FILTERS; filter++)
+		{
+			batch.Filter();
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "sphere pairs batch simd " << simdLevel << ": " << CHECK_SPHERE_PAIRS * (CHECK_SPHERE_FILTERS / seconds) / 1000000.0
+			<< "M per second, " << batch.GetOverlapCount() << " overlap" << std::endl;
+	}
+	std::cout << std::setprecision(6);
+}
+
+void PhysicsCheck::TimeIntegrator()
+{
+	const unsigned int bodyCounts[] = { 10000, 100000, 1000000 };
+	glm::vec2 gravity(0.0f, -10.0f);
+	for (unsigned int count : bodyCounts)
+	{
+		unsigned int steps = CHECK_INTEGRATOR_UPDATES / count;
+		// every timing starts from new bodies, after enough steps the drag takes the sideways velocity of the falling bodies
+		// into denormals, which would slow down whichever timing came last
+		std::vector<Rigidbody*> bodies = MakeIntegratorBodies(count, 9);
+		// the actors in a scene are added and removed over time so they aren't in the order they are in memory
+		std::shuffle(bodies.begin(), bodies.end(), std::mt19937(9));
+
+		auto start = std::chrono::steady_clock::now();
+		for (unsigned int step = 0; step < steps; step++)
+		{
+			for (Rigidbody* body : bodies)
+			{
+				body->FixedUpdate(gravity, 0.01f);
+			}
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << std::setprecision(1) << "integrate bodies " << count << " FixedUpdate: " << count * (steps / seconds) / 1000000.0 << "M per second" << std::endl;
+		for (Rigidbody* body : bodies)
+		{
+			delete body;
+		}
+
+		for (SimdLevel simdLevel : CHECK_SIMD_LEVELS)
+		{
+			BodyStore store;
+			store.SetSimdLevel(simdLevel);
+			if (store.GetSimdLevel() != simdLevel)
+			{
+				continue;
+			}
+			bodies = MakeIntegratorBodies(count, 9);
+			for (Rigidbody* body : bodies)
+			{
+				body->AttachToStore(&store);
+			}
+			start = std::chrono::steady_clock::now();
+			for (unsigned int step = 0; step < steps; step++)
+			{
+				store.Integrate(gravity, 0.01f);
+			}
+			seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			std::cout << "integrate bodies " << count << " store simd " << simdLevel << ": " << count * (steps / seconds) / 1000000.0 << "M per second" << std::endl;
+
+			// the bodies leave the store before it is destroyed so they don't remove themselves from it afterwards
+			for (Rigidbody* body : bodies)
+			{
+				body->DetachFromStore();
+				delete body;
+			}
+		}
+		std::cout << std::setprecision(6);
+	}
+}
\ No newline at end of file
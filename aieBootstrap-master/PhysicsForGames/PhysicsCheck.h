@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include "PhysicsScene.h"
+
+// runs the physics without a window and prints numbers that can be compared between builds, started by passing -check to the
+// program
+// - a hash of where the actors end up for each solver, broadphase and amount of threads, a change that shouldn't change the
+//   simulation should print the same hashes, and the hashes have to be the same for every broadphase and amount of threads
+// - the heap allocations each step makes once the scenes have warmed up, these have to be 0, only checked when
+//   PHYSICS_ALLOCATION_COUNTER is defined
+// - whether the body store integrates exactly like Rigidbody::FixedUpdate at every simd level, the bits have to match
+// - how long one poly to poly test takes for a few amounts of sides, how long checking every pair of a mixed scene takes,
+//   how many circle pairs a second the sphere batch filters and how many bodies a second each way of integrating gets
+//   through, only meaningful in a release build
+// the hash scenes run the narrowphase and the solver on several threads with every type of shape, so building with a thread
+// sanitizer and running the check covers the threaded step
+class PhysicsCheck
+{
+public:
+	// returns 0 if every check passed
+	static int Run();
+
+protected:
+	// fills the scene with a box of planes and a random mix of spheres, boxes and polys, and returns the rigidbodies in the order
+	// they were added
+	static std::vector<Rigidbody*> MakeMixedScene(PhysicsScene& scene, const unsigned int count, const unsigned int seed);
+	// fills the scene with a floor and a pile of rows of spheres or boxes
+	static void MakePileScene(PhysicsScene& scene, const ShapeType shape);
+	// adds up the positions and velocities of the rigidbodies, weighted by their order so swapping two of them changes the sum
+	static double HashBodies(const std::vector<Rigidbody*>& bodies);
+	// makes spheres with random velocities, drags and spins, some of them static or kinematic and some slow enough to be
+	// stopped by the thresholds
+	static std::vector<Rigidbody*> MakeIntegratorBodies(const unsigned int count, const unsigned int seed);
+
+	// prints the hashes and returns false if the threaded results don't agree
+	static bool CheckHashes();
+	// prints the allocations after the warm up and returns false if any step allocated
+	static bool CheckAllocations();
+	// integrates the same bodies with FixedUpdate and with the body store at each simd level and returns false if any of them
+	// end up with different bits
+	static bool CheckIntegrator();
+	// prints the time taken by Poly2Poly on an overlapping pair
+	static void TimePolyPairs();
+	// prints the time taken to check every pair of actors in the mixed scene against each other
+	static void TimeNarrowphase();
+	// prints the circle pairs checked a second by the sphere batch at each simd level
+	static void TimeSphereBatch();
+	// prints the bodies integrated a second by FixedUpdate and by the body store at each simd level
+	static void TimeIntegrator();
+};
\ No newline at end of file
@@ -14,21 +14,47 @@ enum ShapeType
 // the amount of shapes being delt with
 const unsigned int SHAPE_COUNT = POLY + 1;
 
+// the smallest axis aligned box that contains an object
+struct Bounds
+{
+	// bottom left corner
+	glm::vec2 min;
+	// top right corner
+	glm::vec2 max;
+};
+
+// refers to an actor in a physics scene without keeping a pointer to it
+// the scene gives the slot a new generation when the actor is removed, so a handle kept after that stops finding anything
+struct ActorHandle
+{
+	// the slot in the scene the actor was given
+	unsigned int index;
+	// the generation of the slot when the actor was added, slots never use 0 so a handle of zeros is never valid
+	unsigned int generation;
+
+	bool operator==(const ActorHandle& other) const { return index == other.index && generation == other.generation; }
+	bool operator!=(const ActorHandle& other) const { return !(*this == other); }
+};
+
 // abstract class
 class PhysicsObject
 {
 protected:
 	PhysicsObject(const ShapeType& a_shapeID,
 		const glm::vec4& colour = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), const bool kinematic = false, const float s = 0.0f, const float k = 0.0f) :
-		m_shapeID(a_shapeID), m_colour(colour), m_kinematic(kinematic), m_s(s), m_k(k) {}
+		m_shapeID(a_shapeID), m_colour(colour), m_kinematic(kinematic), m_s(s), m_k(k), m_handle{ 0, 0 } {}
 
 public:
+	virtual ~PhysicsObject() {}
+
 	// updates with a fixed time step
 	virtual void FixedUpdate(const glm::vec2& gravity, const float timeStep) = 0;
 	// used to check the variable values
 	virtual void Debug() = 0;
-	// draws the object
-	virtual void MakeGizmo() = 0;
+	// draws the object, alpha is how far between the previous and current fixed step the object should be drawn
+	virtual void MakeGizmo(const float alpha) = 0;
+	// gets the world space box that contains the object, used by the broadphase
+	virtual Bounds GetBounds() const = 0;
 
 	ShapeType GetShapeType() const { return m_shapeID; }
 	void SetStaticFriction(const float s) { m_s = s; }
@@ -37,8 +63,11 @@ public:
 	float GetKineticFriction() const { return m_k; }
 	void SetColour(const glm::vec4& colour) { m_colour = colour; }
 	glm::vec4 GetColour() const { return m_colour; }
-	void SetKinematic(const bool kinematic) { m_kinematic = kinematic; }
+	virtual void SetKinematic(const bool kinematic) { m_kinematic = kinematic; }
 	bool GetKinematic() const { return m_kinematic; }
+	// the handle the scene gave the object when it was added, all zeros while the object isn't in a scene
+	void SetHandle(const ActorHandle& handle) { m_handle = handle; }
+	ActorHandle GetHandle() const { return m_handle; }
 
 protected:
 	// stores the type of shape
@@ -51,4 +80,6 @@ protected:
 	glm::vec4 m_colour;
 	// determines if the object is kinematic
 	bool m_kinematic;
+	// where the scene keeps the object
+	ActorHandle m_handle;
 };
\ No newline at end of file
@@ -6,9 +6,25 @@
 #include "Sphere.h"
 #include "AABB.h"
 #include "Poly.h"
+#include "GJK.h"
+#include "UniformGrid.h"
+#include "SweepAndPrune.h"
+#include "DynamicTree.h"
+#include <algorithm>
+#include "AllocationCounter.h"
+#include "Sweep.h"
+
+// the default limit on the amount of fixed steps run in one update
+#define DEFAULT_MAX_SUB_STEPS 100
+// marks the end of the list of free slots
+#define NO_SLOT 0xFFFFFFFF
+// how far a bullet is left overlapping the shape it was swept into, so the collision functions find the contact
+#define BULLET_OVERLAP 0.01f
+// the distance on top of how far the shapes move in a step that speculative contacts are found at
+#define DEFAULT_SPECULATIVE_MARGIN 0.1f
 
 // function pointer array for doing collisions
-typedef bool(*fn)(PhysicsObject*, PhysicsObject*, const glm::vec2&, const float);
+typedef bool(*fn)(PhysicsObject*, PhysicsObject*, Contact&);
 
 // collection of different collision check functions
 static fn collisionFunctionArray[SHAPE_COUNT][SHAPE_COUNT] =
@@ -19,18 +35,140 @@ static fn collisionFunctionArray[SHAPE_COUNT][SHAPE_COUNT] =
 	{PhysicsScene::Poly2Plane, PhysicsScene::Poly2Sphere, PhysicsScene::Poly2Box, PhysicsScene::Poly2Poly}
 };
 
+// casts the object to the class of its shape without using RTTI
+// the collision function array is indexed by shape type, so checking the type is enough to know the cast is safe
+template<typename T>
+static T* ShapeCast(PhysicsObject* obj)
+{
+	return (obj != nullptr && obj->GetShapeType() == T::SHAPE_TYPE) ? static_cast<T*>(obj) : nullptr;
+}
+
+// the velocity of the second object relative to the first, planes don't move
+static glm::vec2 GetRelativeVelocity(const PhysicsObject* object1, const PhysicsObject* object2)
+{
+	glm::vec2 velocity1 = (object1->GetShapeType() != PLANE) ? static_cast<const Rigidbody*>(object1)->GetVelocity() : glm::vec2(0.0f, 0.0f);
+	glm::vec2 velocity2 = (object2->GetShapeType() != PLANE) ? static_cast<const Rigidbody*>(object2)->GetVelocity() : glm::vec2(0.0f, 0.0f);
+	return velocity2 - velocity1;
+}
+
+// finds the fraction of the displacement at which a circle moving from the start first touches the plane
+// returns false if the circle starts overlapping the plane or doesn't reach it
+static bool SweepPlane(const glm::vec2& start, const glm::vec2& displacement, const float radius, const Plane* plane, float& time)
+{
+	float startDistance = glm::dot(start, plane->GetNormal()) - plane->GetDistance() - radius;
+	float endDistance = startDistance + glm::dot(displacement, plane->GetNormal());
+	if (startDistance < 0.0f || endDistance >= 0.0f)
+	{
+		return false;
+	}
+	time = startDistance / (startDistance - endDistance);
+	return true;
+}
+// checks if the actor overlaps or touches the box from min to max
+static bool OverlapBox(const PhysicsObject* actor, const glm::vec2& min, const glm::vec2& max)
+{
+	glm::vec2 centre = (min + max) * 0.5f;
+	glm::vec2 extents = (max - min) * 0.5f;
+	switch (actor->GetShapeType())
+	{
+	case PLANE:
+	{
+		// the corner of the box furthest behind the plane
+		const Plane* plane = static_cast<const Plane*>(actor);
+		return glm::dot(plane->GetNormal(), centre) - glm::dot(glm::abs(plane->GetNormal()), extents) <= plane->GetDistance();
+	}
+	case SPHERE:
+	{
+		const Sphere* sphere = static_cast<const Sphere*>(actor);
+		glm::vec2 offset = sphere->GetPosition() - glm::clamp(sphere->GetPosition(), min, max);
+		return glm::dot(offset, offset) <= sphere->GetRadius() * sphere->GetRadius();
+	}
+	case BOX:
+	{
+		const AABB* box = static_cast<const AABB*>(actor);
+		return !(box->GetMin().x > max.x || box->GetMin().y > max.y || box->GetMax().x < min.x || box->GetMax().y < min.y);
+	}
+	case POLY:
+	{
+		// separating axis test on the axes of the box and the normals of the poly
+		const Poly* poly = static_cast<const Poly*>(actor);
+		Bounds bounds = poly->GetBounds();
+		if (bounds.min.x > max.x || bounds.min.y > max.y || bounds.max.x < min.x || bounds.max.y < min.y)
+		{
+			return false;
+		}
+		for (const glm::vec2& axis : poly->GetAxis())
+		{
+			glm::vec2 projection = poly->Project(axis);
+			float centreProjection = glm::dot(axis, centre);
+			float extentsProjection = glm::dot(glm::abs(axis), extents);
+			if (projection.x > centreProjection + extentsProjection || projection.y < centreProjection - extentsProjection)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
 PhysicsScene::PhysicsScene()
 {
 	m_timeStep = 0.01f;
 	m_gravity = glm::vec2(0.0f, 0.0f);
+	m_accumulatedTime = 0.0f;
+	m_maxSubSteps = DEFAULT_MAX_SUB_STEPS;
+	m_stepAllocations = 0;
+	m_freeSlot = NO_SLOT;
+	m_stepping = false;
+	m_broadphaseType = BRUTE_FORCE;
+	m_broadphase = nullptr;
+	m_bodyStore = nullptr;
+	m_workers = nullptr;
+	m_sleeping = false;
+	m_nextIsland = 0;
+	m_solverType = IMMEDIATE;
+	m_sphereBatches.resize(1);
+	m_speculative = false;
+	m_speculativeMargin = DEFAULT_SPECULATIVE_MARGIN;
+	m_rayBatches.resize(1);
+	m_queryCandidates.resize(1);
+	m_broadphaseCount = 0;
+	m_querySlack = 0.0f;
 }
 PhysicsScene::PhysicsScene(const glm::vec2& gravity, const float timeStep)
 {
 	m_gravity = gravity;
 	m_timeStep = timeStep;
+	m_accumulatedTime = 0.0f;
+	m_maxSubSteps = DEFAULT_MAX_SUB_STEPS;
+	m_stepAllocations = 0;
+	m_freeSlot = NO_SLOT;
+	m_stepping = false;
+	m_broadphaseType = BRUTE_FORCE;
+	m_broadphase = nullptr;
+	m_bodyStore = nullptr;
+	m_workers = nullptr;
+	m_sleeping = false;
+	m_nextIsland = 0;
+	m_solverType = IMMEDIATE;
+	m_sphereBatches.resize(1);
+	m_speculative = false;
+	m_speculativeMargin = DEFAULT_SPECULATIVE_MARGIN;
+	m_rayBatches.resize(1);
+	m_queryCandidates.resize(1);
+	m_broadphaseCount = 0;
+	m_querySlack = 0.0f;
 }
 PhysicsScene::~PhysicsScene()
 {
+	delete m_workers;
+	m_workers = nullptr;
+	delete m_broadphase;
+	m_broadphase = nullptr;
+
 	// deallocates the actors
 	for (auto pActor : m_actors)
 	{
@@ -41,56 +179,231 @@ PhysicsScene::~PhysicsScene()
 		}
 	}
 	m_actors.clear();
+
+	// the actors remove themselves from the store when they are deleted
+	delete m_bodyStore;
+	m_bodyStore = nullptr;
 }
 
-void PhysicsScene::AddActor(PhysicsObject * actor)
+ActorHandle PhysicsScene::AddActor(PhysicsObject * actor)
 {
+	if (Contains(actor))
+	{
+		return actor->GetHandle();
+	}
+
+	// reuses the slot of a removed actor if there is one
+	unsigned int slot;
+	if (m_freeSlot != NO_SLOT)
+	{
+		slot = m_freeSlot;
+		m_freeSlot = m_slots[slot].actor;
+	}
+	else
+	{
+		slot = m_slots.size();
+		m_slots.push_back({ 0, 1 });
+	}
+	m_slots[slot].actor = m_actors.size();
+	actor->SetHandle({ slot, m_slots[slot].generation });
+
 	m_actors.push_back(actor);
+	// every shape except planes is a rigidbody
+	if (m_bodyStore != nullptr && actor->GetShapeType() != PLANE)
+	{
+		static_cast<Rigidbody*>(actor)->AttachToStore(m_bodyStore);
+	}
+	return actor->GetHandle();
 }
 bool PhysicsScene::RemoveActor(PhysicsObject * actor)
 {
-	// searches through the vector for the object
-	for (unsigned int i = 0; i < m_actors.size(); i++)
+	if (!Contains(actor))
 	{
-		// checks if the object was found
-		if (m_actors[i] == actor)
-		{
-			// increments an iterator that begins at the start of the vector by the current index
-			// removes the object at the index
-			m_actors.erase(m_actors.begin() + i);
-			return true;
-		}
+		return false;
+	}
+	// the step works with the indices of the actors, so they can't be moved until it has finished
+	if (m_stepping)
+	{
+		m_pendingRemovals.push_back(actor);
+		return true;
 	}
 
-	return false;
+	// moves the last actor into the gap so none of the other actors need to be shifted down
+	ActorSlot& slot = m_slots[actor->GetHandle().index];
+	unsigned int index = slot.actor;
+	unsigned int last = m_actors.size() - 1;
+	m_actors[index] = m_actors[last];
+	m_slots[m_actors[index]->GetHandle().index].actor = index;
+	m_actors.pop_back();
+
+	// the next generation stops the handles to the removed actor from working, 0 is skipped so a zeroed handle is never valid
+	slot.generation = (slot.generation == 0xFFFFFFFF) ? 1 : slot.generation + 1;
+	slot.actor = m_freeSlot;
+	m_freeSlot = actor->GetHandle().index;
+	actor->SetHandle({ 0, 0 });
+
+	// the actor takes its state back out of the store
+	if (m_bodyStore != nullptr && actor->GetShapeType() != PLANE)
+	{
+		static_cast<Rigidbody*>(actor)->DetachFromStore();
+	}
+	// the broadphase may be storing the index of the actor that was moved
+	if (m_broadphase != nullptr)
+	{
+		m_broadphase->OnActorRemoved(index, last);
+	}
+	// the queries check every actor until the broadphase has been run again
+	m_broadphaseCount = 0;
+	return true;
+}
+bool PhysicsScene::RemoveActor(const ActorHandle & handle)
+{
+	PhysicsObject* actor = GetActor(handle);
+	return actor != nullptr && RemoveActor(actor);
+}
+PhysicsObject * PhysicsScene::GetActor(const ActorHandle & handle) const
+{
+	if (handle.index >= m_slots.size() || m_slots[handle.index].generation != handle.generation)
+	{
+		return nullptr;
+	}
+	// the actor is checked as well so a made up handle can't get the actor of another slot
+	unsigned int index = m_slots[handle.index].actor;
+	return (index < m_actors.size() && m_actors[index]->GetHandle() == handle) ? m_actors[index] : nullptr;
+}
+bool PhysicsScene::Contains(const PhysicsObject * actor) const
+{
+	return actor != nullptr && GetActor(actor->GetHandle()) == actor;
+}
+void PhysicsScene::RemovePendingActors()
+{
+	// an actor removed more than once is only found the first time
+	for (PhysicsObject* actor : m_pendingRemovals)
+	{
+		RemoveActor(actor);
+	}
+	m_pendingRemovals.clear();
 }
 
 // update physics at a fixed time step
 void PhysicsScene::Update(const float dt)
 {
-	static float accumulatedTime = 0.0f;
-	accumulatedTime += dt;
+	unsigned long long allocations = AllocationCounter::GetCount();
+	m_accumulatedTime += dt;
 
-	while (accumulatedTime >= m_timeStep)
+	unsigned int subSteps = 0;
+	while (m_accumulatedTime >= m_timeStep)
 	{
-		// calls fixed update on all actors
+		// drops the time that can't be caught up on, keeping only the fraction of a step used for interpolation
+		if (m_maxSubSteps != 0 && subSteps == m_maxSubSteps)
+		{
+			m_accumulatedTime = fmodf(m_accumulatedTime, m_timeStep);
+			break;
+		}
+		subSteps++;
+		m_stepping = true;
+
+		// keeps where each rigidbody was before this step so it can be drawn between steps
 		for (auto pActor : m_actors)
 		{
-			pActor->FixedUpdate(m_gravity, m_timeStep);
+			// every shape except planes is a rigidbody
+			if (pActor->GetShapeType() != PLANE)
+			{
+				static_cast<Rigidbody*>(pActor)->SavePreviousState();
+			}
+		}
+
+		if (m_bodyStore != nullptr && m_workers != nullptr)
+		{
+			// each thread integrates a block of the rigidbodies
+			m_workers->ParallelFor(m_bodyStore->GetCount(), [this](unsigned int begin, unsigned int end, unsigned int /*thread*/)
+			{
+				m_bodyStore->Integrate(m_gravity, m_timeStep, begin, end);
+			});
+			for (auto pActor : m_actors)
+			{
+				if (pActor->GetShapeType() == PLANE)
+				{
+					pActor->FixedUpdate(m_gravity, m_timeStep);
+				}
+			}
+		}
+		else if (m_bodyStore != nullptr)
+		{
+			// integrates all the rigidbodies at once
+			m_bodyStore->Integrate(m_gravity, m_timeStep);
+			// only the actors that aren't in the store need to be updated individually
+			for (auto pActor : m_actors)
+			{
+				if (pActor->GetShapeType() == PLANE)
+				{
+					pActor->FixedUpdate(m_gravity, m_timeStep);
+				}
+			}
+		}
+		else if (m_workers != nullptr)
+		{
+			// each actor only changes its own state so they can be updated on any thread
+			m_workers->ParallelFor(m_actors.size(), [this](unsigned int begin, unsigned int end, unsigned int /*thread*/)
+			{
+				for (unsigned int i = begin; i < end; i++)
+				{
+					m_actors[i]->FixedUpdate(m_gravity, m_timeStep);
+				}
+			});
+		}
+		else
+		{
+			// calls fixed update on all actors
+			for (auto pActor : m_actors)
+			{
+				pActor->FixedUpdate(m_gravity, m_timeStep);
+			}
 		}
 
+		// the bullets are moved back to where they first hit anything they passed through this step
+		SweepBullets();
 		// check for collisions
 		CheckForCollision();
 
-		accumulatedTime -= m_timeStep;
+		if (m_sleeping)
+		{
+			UpdateSleeping();
+		}
+
+		m_stepping = false;
+		RemovePendingActors();
+
+		m_accumulatedTime -= m_timeStep;
 	}
+	// the events from the steps can be read until the end of the next update
+	m_contactEvents.Swap();
+
+	// the scratch memory used by the collision functions on each thread is only needed during the steps
+	if (subSteps > 0)
+	{
+		if (m_workers != nullptr)
+		{
+			m_workers->Run([](unsigned int /*thread*/)
+			{
+				StepArena::GetThreadArena().Reset();
+			});
+		}
+		else
+		{
+			StepArena::GetThreadArena().Reset();
+		}
+	}
+	m_stepAllocations = AllocationCounter::GetCount() - allocations;
 }
 // draws all the actors
 void PhysicsScene::UpdateGizmos()
 {
+	// the actors are drawn between the last two steps using the time left over in the accumulator
+	float alpha = GetAlpha();
 	for (auto pActor : m_actors)
 	{
-		pActor->MakeGizmo();
+		pActor->MakeGizmo(alpha);
 	}
 }
 // calls the debug function of each actor
@@ -105,419 +418,962 @@ void PhysicsScene::DebugScene()
 	}
 }
 
-// checks for collision between all actors in the scene
-void PhysicsScene::CheckForCollision()
-{	
-	int actorCount = m_actors.size();
+void PhysicsScene::SetBroadphase(const BroadphaseType broadphaseType)
+{
+	if (broadphaseType == m_broadphaseType)
+	{
+		return;
+	}
 
-	// need to check for collision against all objects except this one
-	for (int outer = 0; outer < actorCount - 1; outer++)
+	// replaces the current broadphase
+	delete m_broadphase;
+	m_broadphase = nullptr;
+	m_broadphaseType = broadphaseType;
+	m_broadphaseCount = 0;
+	switch (broadphaseType)
 	{
-		for (int inner = outer + 1; inner < actorCount; inner++)
-		{
-			PhysicsObject* object1 = m_actors[outer];
-			PhysicsObject* object2 = m_actors[inner];
-			int shapeID1 = object1->GetShapeType();
-			int shapeID2 = object2->GetShapeType();
+	case UNIFORM_GRID:
+		m_broadphase = new UniformGrid();
+		break;
+	case SWEEP_AND_PRUNE:
+		m_broadphase = new SweepAndPrune();
+		break;
+	case DYNAMIC_TREE:
+		m_broadphase = new DynamicTree();
+		break;
+	default: // brute force does not need an object
+		break;
+	}
+}
+void PhysicsScene::SetBodyStorage(const bool enabled)
+{
+	if (enabled == (m_bodyStore != nullptr))
+	{
+		return;
+	}
 
-			// gets the function based on which 2 objects are being checked against
-			fn collisionFunctionPtr = collisionFunctionArray[shapeID1][shapeID2];
-			if (collisionFunctionPtr != nullptr)
+	// every shape except planes is a rigidbody
+	if (enabled)
+	{
+		m_bodyStore = new BodyStore();
+		for (auto pActor : m_actors)
+		{
+			if (pActor->GetShapeType() != PLANE)
 			{
-				// did a collision occur
-				collisionFunctionPtr(object1, object2, m_gravity, m_timeStep);
+				static_cast<Rigidbody*>(pActor)->AttachToStore(m_bodyStore);
 			}
 		}
 	}
+	else
+	{
+		// copies the state back into each rigidbody before the store is deleted
+		for (auto pActor : m_actors)
+		{
+			if (pActor->GetShapeType() != PLANE)
+			{
+				static_cast<Rigidbody*>(pActor)->DetachFromStore();
+			}
+		}
+		delete m_bodyStore;
+		m_bodyStore = nullptr;
+	}
 }
 
-#pragma region Plane Collision
-// does nothing because planes don't collide
-bool PhysicsScene::Plane2Plane(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2& gravity, const float timeStep)
+void PhysicsScene::SetThreadCount(const unsigned int threadCount)
 {
-	return false;
-}
-// swaps the order of the objects and passes them into the opposite function
-bool PhysicsScene::Plane2Sphere(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2& gravity, const float timeStep)
-{
-	return Sphere2Plane(obj2, obj1, gravity, timeStep);
+	if (threadCount == GetThreadCount())
+	{
+		return;
+	}
+
+	delete m_workers;
+	m_workers = nullptr;
+	// a single thread doesn't need a pool
+	if (threadCount > 1)
+	{
+		m_workers = new WorkerPool(threadCount);
+	}
+	m_threadContacts.resize(GetThreadCount());
+	m_threadPairs.resize(GetThreadCount());
+	m_threadAxes.resize(GetThreadCount());
+	m_sphereBatches.resize(GetThreadCount());
+	m_rayBatches.resize(GetThreadCount());
+	m_queryCandidates.resize(GetThreadCount());
 }
-// swaps the order of the objects and passes them into the opposite function
-bool PhysicsScene::Plane2Box(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2& gravity, const float timeStep)
+void PhysicsScene::SetSolver(const SolverType solverType)
 {
-	return Box2Plane(obj2, obj1, gravity, timeStep);
+	// the cache stops being updated while the solver isn't used, so the impulses in it would be out of date
+	if (solverType != m_solverType)
+	{
+		m_contactSolver.GetCache().Clear();
+	}
+	m_solverType = solverType;
 }
-// swaps the order of the objects and passes them into the opposite function
-bool PhysicsScene::Plane2Poly(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2 & gravity, const float timeStep)
+void PhysicsScene::SetSleeping(const bool sleeping)
 {
-	return Poly2Plane(obj2, obj1, gravity, timeStep);
+	m_sleeping = sleeping;
+	if (!m_sleeping)
+	{
+		// nothing will wake the rigidbodies that are asleep
+		for (auto pActor : m_actors)
+		{
+			if (pActor->GetShapeType() != PLANE)
+			{
+				static_cast<Rigidbody*>(pActor)->SetAwake(true);
+				static_cast<Rigidbody*>(pActor)->SetSleepIsland(NO_ISLAND);
+			}
+		}
+	}
 }
-#pragma endregion
 
-#pragma region Sphere Collision
-bool PhysicsScene::Sphere2Plane(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2& gravity, const float timeStep)
-{
-	// try to cast objects to sphere and plane
-	Sphere* sphere = dynamic_cast<Sphere*>(obj1);
-	Plane* plane = dynamic_cast<Plane*>(obj2);
-	// if successful then test for collision
-	if (sphere != nullptr && plane != nullptr)
+// checks for collision between all actors in the scene
+void PhysicsScene::CheckForCollision()
+{	
+	m_collidingPairs.clear();
+	m_contacts.clear();
+	m_gjkCache.BeginStep();
+	// the broadphase needs to find the pairs that are apart but could touch in the next step
+	if (m_broadphase != nullptr)
 	{
-		// uses the plane's normal as the collision normal
-		glm::vec2 normal = plane->GetNormal();
-		// determines the distance between the circle and the plane
-		float sphereToPlane = glm::dot(sphere->GetPosition(), normal) - plane->GetDistance();
+		m_broadphase->SetExpansion(m_speculative ? m_speculativeMargin : 0.0f, m_speculative ? m_timeStep : 0.0f);
+		// nothing moves between here and the broadphase being run, the queries need to know how far the contacts move the actors
+		m_broadphasePositions.resize(m_actors.size());
+		for (unsigned int i = 0; i < m_actors.size(); i++)
+		{
+			m_broadphasePositions[i] = (m_actors[i]->GetShapeType() != PLANE) ? static_cast<Rigidbody*>(m_actors[i])->GetPosition() : glm::vec2(0.0f, 0.0f);
+		}
+	}
+	if (m_workers != nullptr)
+	{
+		CheckForCollisionParallel();
+	}
+	// without a broadphase every actor is checked against every other actor
+	else if (m_broadphase == nullptr)
+	{
+		int actorCount = m_actors.size();
 
-		// the amount the circle overlaps the plane
-		float overlap = sphere->GetRadius() - sphereToPlane;
-		// if the overlap amount is positive then a collision occurred
-		if (overlap >= 0)
+		// need to check for collision against all objects except this one
+		for (int outer = 0; outer < actorCount - 1; outer++)
 		{
-			// if either object is kinematic then there is no collision resolution
-			// if the circle is static then there is no collision resolution because both objects will not move
-			if (sphere->GetKinematic() || plane->GetKinematic() || sphere->GetStatic())
+			for (int inner = outer + 1; inner < actorCount; inner++)
 			{
-				return true;
+				if (CheckForCollision(m_actors[outer], m_actors[inner]))
+				{
+					m_collidingPairs.push_back({ (unsigned int)outer, (unsigned int)inner });
+				}
 			}
-
-			// uses the circle's velocity as the relative velocity
-			glm::vec2 relativeVelocity = sphere->GetVelocity();
-
-			// sphere to plane restitution
-			// determines which direction of velocity is away from the other object
-			if (glm::dot(relativeVelocity + (gravity * timeStep), normal) > 0.0f)
+		}
+	}
+	else
+	{
+		// only checks the actors that the broadphase found might be colliding
+		m_broadphase->FindPairs(m_actors, m_pairs);
+		// the immediate solver moves the actors as it goes, so the circles can only be filtered up front for the solver
+		bool filtered = m_solverType == SEQUENTIAL_IMPULSE;
+		SphereBatch& spheres = m_sphereBatches[0];
+		if (filtered)
+		{
+			FilterSpheres(0, m_pairs.size(), spheres);
+		}
+		unsigned int nextSphere = 0;
+		for (unsigned int i = 0; i < m_pairs.size(); i++)
+		{
+			PhysicsObject* object1 = m_actors[m_pairs[i].first];
+			PhysicsObject* object2 = m_actors[m_pairs[i].second];
+			if (filtered && IsSpherePair(object1, object2))
 			{
-				ApplyResitiution(sphere, relativeVelocity + (gravity * timeStep), normal, overlap);
+				// the overlapping circles are in pair order, any other pair of circles doesn't collide
+				if (nextSphere == spheres.GetOverlapCount() || spheres.GetOverlaps()[nextSphere] != i)
+				{
+					continue;
+				}
+				nextSphere++;
 			}
-			else
+			if (CheckForCollision(object1, object2))
 			{
-				ApplyResitiution(sphere, -(relativeVelocity + (gravity * timeStep)), normal, overlap);
+				m_collidingPairs.push_back(m_pairs[i]);
 			}
+		}
+	}
 
-			// uses the elasticity of the circle
-			float elasticity = sphere->GetElasticity();
-			// "j" is the magnitude of the force vector that needs to be applied to the objects
-			// for planes the formula is: (j = (-(1 + e)v.rel)·n) / (1 / m)
-			float j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * (1 / sphere->GetMass()));
-
-			// scales the normal by the impulse magnitude to get the resolution force
-			glm::vec2 force = normal * j;
+	// the pairs that stopped being checked don't need a direction any more
+	m_gjkCache.EndStep();
 
-			// the contact point is found by scaling the normal by the radius and taking that vector from the position
-			glm::vec2 contact = sphere->GetPosition() - (normal * sphere->GetRadius());
+	// the contacts have only been stored so far, so they are all solved together once every contact has been found
+	if (m_solverType == SEQUENTIAL_IMPULSE)
+	{
+		m_contactSolver.Solve(m_contacts, m_timeStep, m_workers);
+	}
 
-			// applys the friction force to the object
-			ApplyFriction(sphere, force, contact, gravity, timeStep, plane->GetStaticFriction(), plane->GetKineticFriction());
+	if (m_contactEvents.IsEnabled())
+	{
+		// the pairs where neither actor can move aren't checked, so they are still touching unless an actor was removed
+		m_contactEvents.EndStep([this](const ContactEvent& event)
+		{
+			PhysicsObject* object1 = GetActor(event.object1);
+			PhysicsObject* object2 = GetActor(event.object2);
+			return object1 != nullptr && object2 != nullptr && !IsActive(object1) && !IsActive(object2);
+		});
+	}
 
-			return true;
+	// the bounds in the broadphase are from before the contacts were resolved
+	if (m_broadphase != nullptr)
+	{
+		float slack = 0.0f;
+		for (unsigned int i = 0; i < m_actors.size(); i++)
+		{
+			if (m_actors[i]->GetShapeType() != PLANE)
+			{
+				glm::vec2 moved = static_cast<Rigidbody*>(m_actors[i])->GetPosition() - m_broadphasePositions[i];
+				slack = fmaxf(slack, glm::dot(moved, moved));
+			}
 		}
+		m_querySlack = sqrtf(slack);
+		m_broadphaseCount = m_actors.size();
 	}
-
-	return false;
 }
-bool PhysicsScene::Sphere2Sphere(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2& gravity, const float timeStep)
+void PhysicsScene::CheckForCollisionParallel()
 {
-	// try to cast objects to spheres
-	Sphere* sphere1 = dynamic_cast<Sphere*>(obj1);
-	Sphere* sphere2 = dynamic_cast<Sphere*>(obj2);
-	// if successful then test for collision
-	if (sphere1 != nullptr && sphere2 != nullptr)
+	for (unsigned int i = 0; i < m_threadContacts.size(); i++)
 	{
-		// determines the distance between the two circles
-		float distance = glm::distance(sphere1->GetPosition(), sphere2->GetPosition());
-		// sum of the two radii
-		float radii = sphere1->GetRadius() + sphere2->GetRadius();
+		m_threadContacts[i].clear();
+		m_threadPairs[i].clear();
+		m_threadAxes[i].clear();
+	}
 
-		// checks if the distance is less than the sum of the two radii
-		if (distance <= radii)
+	// the polys move their vertices to where they are now before the threads read them
+	for (PhysicsObject* actor : m_actors)
+	{
+		if (actor->GetShapeType() == POLY)
 		{
-			// if either object is kinematic then there is no collision resolution
-			// if both objects are static then there will be no collision resolution because neither object will move
-			if (sphere1->GetKinematic() || sphere2->GetKinematic() || (sphere1->GetStatic() && sphere2->GetStatic()))
-			{
-				return true;
-			}
+			static_cast<Poly*>(actor)->UpdateWorldVertices();
+		}
+	}
 
-			// the collision normal is the vector between the circles' positions
-			glm::vec2 normal = glm::normalize(sphere2->GetPosition() - sphere1->GetPosition());
-			// the difference between the velocities is the relative velocity
-			glm::vec2 relativeVelocity = sphere2->GetVelocity() - sphere1->GetVelocity();
-
-			// the individual momentums of the circles
-			float p1 = sphere1->GetMass() * glm::length(sphere1->GetVelocity());
-			float p2 = sphere2->GetMass() * glm::length(sphere2->GetVelocity());
-			// the sum of the two momentums
-			float momentum = p1 + p2;
-			// the amount the two circles overlap
-			float overlap = radii - distance;
-			// seperates the overlap based on the ratio of the momentums of the two circles
-			float overlap1 = overlap * (p2 / momentum);
-			float overlap2 = overlap * (p1 / momentum);
-
-			// uses the average elasticity of the two circles
-			float elasticity;
-			// "j" is the magnitude of the force vector that needs to be applied to the objects
-			float j;
-
-			// sphere to sphere restitution
-			// checks if both objects are not static
-			if (!sphere1->GetStatic() && !sphere2->GetStatic())
+	if (m_broadphase == nullptr)
+	{
+		// gives each thread a block of outer actors with roughly the same amount of pairs
+		// the first actors have the most pairs so their blocks are smaller
+		unsigned int actorCount = m_actors.size();
+		unsigned int threadCount = m_workers->GetThreadCount();
+		unsigned long long pairCount = (unsigned long long)actorCount * (actorCount - 1) / 2;
+		m_workers->Run([&](unsigned int thread)
+		{
+			unsigned long long firstPair = pairCount * thread / threadCount;
+			unsigned long long lastPair = pairCount * (thread + 1) / threadCount;
+			unsigned long long pairs = 0;
+			for (unsigned int outer = 0; outer + 1 < actorCount; outer++)
 			{
-				// determines which direction of velocity is away from the other object
-				if (glm::dot(sphere1->GetVelocity() + (gravity * timeStep), -normal) > 0.0f)
-				{
-					ApplyResitiution(sphere1, sphere1->GetVelocity() + (gravity * timeStep), -normal, overlap1);
-				}
-				else
+				// the pairs before this actor's block of pairs
+				unsigned long long start = pairs;
+				pairs += actorCount - 1 - outer;
+				// an outer actor belongs to the thread whose block contains its first pair
+				if (start < firstPair || start >= lastPair)
 				{
-					ApplyResitiution(sphere1, -(sphere1->GetVelocity() + (gravity * timeStep)), -normal, overlap1);
+					continue;
 				}
-				if (glm::dot(sphere2->GetVelocity() + (gravity * timeStep), normal) > 0.0f)
-				{
-					ApplyResitiution(sphere2, sphere2->GetVelocity() + (gravity * timeStep), normal, overlap2);
-				}
-				else
+				for (unsigned int inner = outer + 1; inner < actorCount; inner++)
 				{
-					ApplyResitiution(sphere2, -(sphere2->GetVelocity() + (gravity * timeStep)), normal, overlap2);
+					// pairs of objects that can't move don't need to be checked
+					if (!IsActive(m_actors[outer]) && !IsActive(m_actors[inner]))
+					{
+						continue;
+					}
+					Contact contact;
+					if (FindContact(m_actors[outer], m_actors[inner], contact, thread))
+					{
+						m_threadContacts[thread].push_back(contact);
+						m_threadPairs[thread].push_back({ outer, inner });
+					}
 				}
-
-				elasticity = (sphere1->GetElasticity() + sphere2->GetElasticity()) / 2.0f;
-				// the formula is: (j = (-(1 + e)v.rel)·n) / n·(n((1 / m.1) + (1 / m.2)))
-				j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * ((1 / sphere1->GetMass()) + (1 / sphere2->GetMass())));
 			}
-			// checks if only sphere1 is not static
-			else if (!sphere1->GetStatic() && sphere2->GetStatic())
+		});
+	}
+	else
+	{
+		// only checks the actors that the broadphase found might be colliding
+		m_broadphase->FindPairs(m_actors, m_pairs);
+		// a thread finds at most one contact for each pair in its block, so with room for a block the lists only grow when the
+		// pairs do, instead of whenever the contacts move from one block to another
+		unsigned int blockSize = m_pairs.capacity() / m_workers->GetThreadCount() + 1;
+		for (unsigned int i = 0; i < m_threadContacts.size(); i++)
+		{
+			m_threadContacts[i].reserve(blockSize);
+			m_threadPairs[i].reserve(blockSize);
+		}
+		m_workers->ParallelFor(m_pairs.size(), [this](unsigned int begin, unsigned int end, unsigned int thread)
+		{
+			// nothing is moved until every thread has finished, so each thread filters the circles in its block first
+			SphereBatch& spheres = m_sphereBatches[thread];
+			FilterSpheres(begin, end, spheres);
+			unsigned int nextSphere = 0;
+			for (unsigned int i = begin; i < end; i++)
 			{
-				// gives the object the full overlap amount because the other object is static
-				if (glm::dot(sphere1->GetVelocity() + (gravity * timeStep), -normal) > 0.0f)
+				PhysicsObject* object1 = m_actors[m_pairs[i].first];
+				PhysicsObject* object2 = m_actors[m_pairs[i].second];
+				if (IsSpherePair(object1, object2))
 				{
-					ApplyResitiution(sphere1, sphere1->GetVelocity() + (gravity * timeStep), -normal, overlap);
+					if (nextSphere == spheres.GetOverlapCount() || spheres.GetOverlaps()[nextSphere] != i)
+					{
+						continue;
+					}
+					nextSphere++;
 				}
-				else
+				// pairs of objects that can't move don't need to be checked
+				if (!IsActive(object1) && !IsActive(object2))
 				{
-					ApplyResitiution(sphere1, -(sphere1->GetVelocity() + (gravity * timeStep)), -normal, overlap);
+					continue;
 				}
+				Contact contact;
+				if (FindContact(object1, object2, contact, thread))
+				{
+					m_threadContacts[thread].push_back(contact);
+					m_threadPairs[thread].push_back(m_pairs[i]);
+				}
+			}
+		});
+	}
+
+	// each thread checked a block of pairs in order, so joining the blocks in thread order keeps the contacts in pair order
+	for (unsigned int i = 0; i < m_threadContacts.size(); i++)
+	{
+		m_contacts.insert(m_contacts.end(), m_threadContacts[i].begin(), m_threadContacts[i].end());
+		m_collidingPairs.insert(m_collidingPairs.end(), m_threadPairs[i].begin(), m_threadPairs[i].end());
+		for (const PairAxis& pairAxis : m_threadAxes[i])
+		{
+			m_gjkCache.Store(pairAxis.key, pairAxis.axis);
+		}
+	}
+	if (m_contactEvents.IsEnabled())
+	{
+		for (const Contact& contact : m_contacts)
+		{
+			m_contactEvents.AddContact(contact);
+		}
+	}
+	// the solver is run after the contacts from the serial paths are found too
+	if (m_solverType == IMMEDIATE)
+	{
+		for (const Contact& contact : m_contacts)
+		{
+			ResolveContact(contact, m_gravity, m_timeStep);
+		}
+	}
+}
+bool PhysicsScene::FindContact(PhysicsObject * object1, PhysicsObject * object2, Contact & contact, const unsigned int thread)
+{
+	int shapeID1 = object1->GetShapeType();
+	int shapeID2 = object2->GetShapeType();
+
+	// gets the function based on which 2 objects are being checked against
+	fn collisionFunctionPtr = collisionFunctionArray[shapeID1][shapeID2];
+	if (collisionFunctionPtr == nullptr)
+	{
+		return false;
+	}
+	contact.margin = GetSpeculativeDistance(object1, object2);
+	bool collided;
+	if (!UsesGJK(object1, object2))
+	{
+		// did a collision occur
+		collided = collisionFunctionPtr(object1, object2, contact);
+	}
+	else
+	{
+		ContactKey key = { object1->GetHandle(), object2->GetHandle() };
+		contact.axis = m_gjkCache.Find(key);
+		collided = collisionFunctionPtr(object1, object2, contact);
+		// the cache can only be read while other threads are checking pairs
+		if (m_workers != nullptr)
+		{
+			m_threadAxes[thread].push_back({ key, contact.axis });
+		}
+		else
+		{
+			m_gjkCache.Store(key, contact.axis);
+		}
+	}
+
+	// the margin allowed for the objects moving at their relative speed in any direction, now that the normal is known the
+	// speculative contacts that are further apart than the objects can close along it are dropped
+	if (collided && contact.overlap < 0.0f)
+	{
+		float closingSpeed = fmaxf(-glm::dot(GetRelativeVelocity(object1, object2), contact.normal), 0.0f);
+		collided = -contact.overlap <= m_speculativeMargin + closingSpeed * m_timeStep;
+	}
+	return collided;
+}
+bool PhysicsScene::UsesGJK(const PhysicsObject * object1, const PhysicsObject * object2)
+{
+	// every pair with a poly in it except for planes, which aren't convex shapes
+	ShapeType shape1 = object1->GetShapeType();
+	ShapeType shape2 = object2->GetShapeType();
+	return (shape1 == POLY || shape2 == POLY) && shape1 != PLANE && shape2 != PLANE;
+}
+void PhysicsScene::FilterSpheres(const unsigned int begin, const unsigned int end, SphereBatch & batch) const
+{
+	batch.Clear();
+	for (unsigned int i = begin; i < end; i++)
+	{
+		PhysicsObject* object1 = m_actors[m_pairs[i].first];
+		PhysicsObject* object2 = m_actors[m_pairs[i].second];
+		if (IsSpherePair(object1, object2))
+		{
+			const Sphere* sphere1 = static_cast<const Sphere*>(object1);
+			const Sphere* sphere2 = static_cast<const Sphere*>(object2);
+			batch.Add(i, sphere1->GetPosition(), sphere2->GetPosition(), sphere1->GetRadius() + sphere2->GetRadius() + GetSpeculativeDistance(object1, object2));
+		}
+	}
+	batch.Filter();
+}
+bool PhysicsScene::IsSpherePair(const PhysicsObject * object1, const PhysicsObject * object2)
+{
+	return object1->GetShapeType() == SPHERE && object2->GetShapeType() == SPHERE;
+}
+float PhysicsScene::GetSpeculativeDistance(const PhysicsObject * object1, const PhysicsObject * object2) const
+{
+	if (!m_speculative)
+	{
+		return 0.0f;
+	}
+	// the objects can't move closer than their relative speed allows during the next step
+	return m_speculativeMargin + glm::length(GetRelativeVelocity(object1, object2)) * m_timeStep;
+}
+bool PhysicsScene::CheckForCollision(PhysicsObject * object1, PhysicsObject * object2)
+{
+	// pairs of objects that can't move don't need to be checked, this skips static and sleeping objects resting on each other
+	if (!IsActive(object1) && !IsActive(object2))
+	{
+		return false;
+	}
+
+	Contact contact;
+	if (FindContact(object1, object2, contact, 0))
+	{
+		if (m_contactEvents.IsEnabled())
+		{
+			m_contactEvents.AddContact(contact);
+		}
+		if (m_solverType == SEQUENTIAL_IMPULSE)
+		{
+			m_contacts.push_back(contact);
+		}
+		else
+		{
+			ResolveContact(contact, m_gravity, m_timeStep);
+		}
+		return true;
+	}
+
+	return false;
+}
+bool PhysicsScene::IsActive(const PhysicsObject * obj)
+{
+	if (obj->GetShapeType() == PLANE)
+	{
+		return false;
+	}
+	const Rigidbody* body = static_cast<const Rigidbody*>(obj);
+	return !body->GetStatic() && body->GetAwake();
+}
+bool PhysicsScene::IsDynamic(const PhysicsObject * obj)
+{
+	if (obj->GetShapeType() == PLANE)
+	{
+		return false;
+	}
+	const Rigidbody* body = static_cast<const Rigidbody*>(obj);
+	return !body->GetStatic() && !body->GetKinematic();
+}
+
+void PhysicsScene::SweepBullets()
+{
+	// how far from its bounds in the broadphase a box can be during the step, less than 0 until a bullet needs it
+	float boxReach = -1.0f;
+	for (PhysicsObject* actor : m_actors)
+	{
+		ShapeType shape = actor->GetShapeType();
+		if (shape != SPHERE && shape != BOX)
+		{
+			continue;
+		}
+		Rigidbody* bullet = static_cast<Rigidbody*>(actor);
+		if (!bullet->GetBullet() || !IsDynamic(bullet) || !bullet->GetAwake())
+		{
+			continue;
+		}
+		glm::vec2 start = bullet->GetPreviousPosition();
+		glm::vec2 displacement = bullet->GetPosition() - start;
+		if (displacement.x == 0.0f && displacement.y == 0.0f)
+		{
+			continue;
+		}
+
+		// the sweeps stop short of touching by the overlap, which can't be more than the size of the bullet
+		glm::vec2 extents = (shape == BOX) ? static_cast<AABB*>(bullet)->GetExtents() : glm::vec2(0.0f, 0.0f);
+		float radius = (shape == SPHERE) ? static_cast<Sphere*>(bullet)->GetRadius() : std::min(extents.x, extents.y);
+		float overlap = std::min(BULLET_OVERLAP, radius * 0.5f);
 
-				// uses the elasticity of sphere1
-				elasticity = sphere1->GetElasticity();
-				// the formula is: (j = (-(1 + e)v.rel)·n) / (1 / m), because sphere2 has infinite mass when static
-				j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * (1 / sphere1->GetMass()));
+		// only the actors near the path are checked, the planes are always found by the broadphase
+		std::vector<unsigned int>& targets = m_queryCandidates[0];
+		targets.clear();
+		unsigned int checked = 0;
+		if (m_broadphase != nullptr && m_broadphaseCount > 0)
+		{
+			if (boxReach < 0.0f)
+			{
+				boxReach = GetBoxReach();
 			}
-			// checks if only sphere 2 is not static
-			else if (sphere1->GetStatic() && !sphere2->GetStatic())
+			Bounds path;
+			path.min = glm::min(start, start + displacement);
+			path.max = glm::max(start, start + displacement);
+			m_broadphase->QueryBounds(Broadphase::Grow(path, std::max(radius, std::max(extents.x, extents.y)) + boxReach), targets);
+			// the earliest hit is kept, so the targets are checked in the order of the actors to pick the same one on a tie
+			std::sort(targets.begin(), targets.end());
+			checked = m_broadphaseCount;
+		}
+		// without a broadphase, or for the actors it hasn't seen yet, every actor is checked
+		for (unsigned int i = checked; i < m_actors.size(); i++)
+		{
+			targets.push_back(i);
+		}
+
+		// the earliest hit and where the bullet is moved to for it
+		float time = 1.0f;
+		glm::vec2 position = bullet->GetPosition();
+		for (unsigned int index : targets)
+		{
+			PhysicsObject* target = m_actors[index];
+			float hit = 1.0f;
+			if (target->GetShapeType() == PLANE)
 			{
-				// gives the object the full overlap amount because the other object is static
-				if (glm::dot(sphere2->GetVelocity() + (gravity * timeStep), normal) > 0.0f)
+				Plane* plane = static_cast<Plane*>(target);
+				// the corner of a box furthest behind the plane reaches it when a circle of this radius would
+				float planeRadius = (shape == SPHERE) ? radius : glm::dot(glm::abs(plane->GetNormal()), extents);
+				if (SweepPlane(start, displacement, planeRadius - overlap, plane, hit) && hit < time)
 				{
-					ApplyResitiution(sphere2, sphere2->GetVelocity() + (gravity * timeStep), normal, overlap1);
+					time = hit;
+					position = start + displacement * hit;
 				}
-				else
+			}
+			else if (shape == SPHERE && target->GetShapeType() == BOX)
+			{
+				// the sweep is done relative to the box as it was before the step, so a moving box is hit where it was at
+				// that time, the bullet is then placed against where the box is now
+				AABB* box = static_cast<AABB*>(target);
+				glm::vec2 relativeStart = start - box->GetPreviousPosition();
+				glm::vec2 relativeDisplacement = displacement - (box->GetPosition() - box->GetPreviousPosition());
+				glm::vec2 normal;
+				if (SweepBox(SweepSegment(relativeStart, relativeDisplacement), radius - overlap, -box->GetExtents(), box->GetExtents(), hit, normal) && hit < time)
 				{
-					ApplyResitiution(sphere2, -(sphere2->GetVelocity() + (gravity * timeStep)), normal, overlap1);
+					time = hit;
+					position = box->GetPosition() + relativeStart + relativeDisplacement * hit;
 				}
+			}
+		}
 
-				// uses the elasticity of sphere2
-				elasticity = sphere2->GetElasticity();
-				// the formula is: (j = (-(1 + e)v.rel)·n) / (1 / m), because sphere1 has infinite mass when static
-				j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * (1 / sphere2->GetMass()));
+		// the rest of the step is lost, the velocity is left for the collision to change
+		if (time < 1.0f)
+		{
+			bullet->SetPosition(position);
+		}
+	}
+}
+float PhysicsScene::GetBoxReach() const
+{
+	float moved = 0.0f;
+	for (PhysicsObject* actor : m_actors)
+	{
+		if (actor->GetShapeType() == BOX)
+		{
+			const Rigidbody* box = static_cast<const Rigidbody*>(actor);
+			glm::vec2 step = box->GetPosition() - box->GetPreviousPosition();
+			moved = fmaxf(moved, glm::dot(step, step));
+		}
+	}
+	return sqrtf(moved) + m_querySlack;
+}
+void PhysicsScene::UpdateSleeping()
+{
+	unsigned int actorCount = m_actors.size();
+
+	// a rigidbody that was woken up wakes the rest of the island it fell asleep with
+	m_wokenIslands.clear();
+	for (auto pActor : m_actors)
+	{
+		if (pActor->GetShapeType() == PLANE)
+		{
+			continue;
+		}
+		Rigidbody* body = static_cast<Rigidbody*>(pActor);
+		if (body->GetAwake() && body->GetSleepIsland() != NO_ISLAND)
+		{
+			m_wokenIslands.push_back(body->GetSleepIsland());
+			body->SetSleepIsland(NO_ISLAND);
+		}
+	}
+	if (!m_wokenIslands.empty())
+	{
+		std::sort(m_wokenIslands.begin(), m_wokenIslands.end());
+		for (auto pActor : m_actors)
+		{
+			if (pActor->GetShapeType() == PLANE)
+			{
+				continue;
 			}
+			Rigidbody* body = static_cast<Rigidbody*>(pActor);
+			if (body->GetSleepIsland() != NO_ISLAND && std::binary_search(m_wokenIslands.begin(), m_wokenIslands.end(), body->GetSleepIsland()))
+			{
+				body->SetAwake(true);
+				body->SetSleepIsland(NO_ISLAND);
+			}
+		}
+	}
+
+	// joins the rigidbodies that are touching into islands
+	// static and kinematic objects don't join islands together, so piles resting on the same floor can sleep separately
+	m_islands.Reset(actorCount);
+	for (const CollisionPair& pair : m_collidingPairs)
+	{
+		if (IsDynamic(m_actors[pair.first]) && IsDynamic(m_actors[pair.second]))
+		{
+			m_islands.Union(pair.first, pair.second);
+		}
+	}
+
+	// an island can only sleep once every rigidbody in it has been resting for long enough
+	m_islandReady.assign(actorCount, 1);
+	for (unsigned int i = 0; i < actorCount; i++)
+	{
+		if (!IsDynamic(m_actors[i]))
+		{
+			continue;
+		}
+		Rigidbody* body = static_cast<Rigidbody*>(m_actors[i]);
+		if (body->GetAwake() && !body->UpdateRestTime(m_timeStep))
+		{
+			m_islandReady[m_islands.Find(i)] = 0;
+		}
+	}
+
+	// puts the islands that are ready to sleep, giving each island its own id so they can be woken together
+	m_islandIds.assign(actorCount, NO_ISLAND);
+	for (unsigned int i = 0; i < actorCount; i++)
+	{
+		if (!IsDynamic(m_actors[i]))
+		{
+			continue;
+		}
+		Rigidbody* body = static_cast<Rigidbody*>(m_actors[i]);
+		unsigned int island = m_islands.Find(i);
+		if (!body->GetAwake() || !m_islandReady[island])
+		{
+			continue;
+		}
+		if (m_islandIds[island] == NO_ISLAND)
+		{
+			m_islandIds[island] = m_nextIsland;
+			// the ids wrap around before reaching the value used for no island
+			m_nextIsland = (m_nextIsland + 1) & 0x7FFFFFFF;
+		}
+		body->SetAwake(false);
+		body->SetSleepIsland(m_islandIds[island]);
+	}
+}
+
+bool PhysicsScene::Raycast(const glm::vec2 & start, const glm::vec2 & end, RaycastHit & hit)
+{
+	return CircleCast(start, end, 0.0f, hit);
+}
+void PhysicsScene::RaycastAll(const glm::vec2 & start, const glm::vec2 & end, std::vector<RaycastHit>& hits)
+{
+	hits.clear();
+	FindCastCandidates(start, end, 0.0f, m_queryCandidates[0]);
+	CastCandidates(start, end, 0.0f, m_queryCandidates[0], m_rayBatches[0]);
+	m_rayBatches[0].SortHits();
+	for (unsigned int i = 0; i < m_rayBatches[0].GetHitCount(); i++)
+	{
+		hits.push_back(MakeHit(m_rayBatches[0].GetHits()[i], start, end, 0.0f));
+	}
+}
+bool PhysicsScene::CircleCast(const glm::vec2 & start, const glm::vec2 & end, const float radius, RaycastHit & hit)
+{
+	FindCastCandidates(start, end, radius, m_queryCandidates[0]);
+	CastCandidates(start, end, radius, m_queryCandidates[0], m_rayBatches[0]);
+	return GetNearestHit(m_rayBatches[0], start, end, radius, hit);
+}
+void PhysicsScene::OverlapAABB(const glm::vec2 & min, const glm::vec2 & max, std::vector<PhysicsObject*>& actors)
+{
+	actors.clear();
+	std::vector<unsigned int>& candidates = m_queryCandidates[0];
+	candidates.clear();
+	unsigned int checked = 0;
+	if (m_broadphase != nullptr && m_broadphaseCount > 0)
+	{
+		Bounds bounds;
+		bounds.min = min;
+		bounds.max = max;
+		m_broadphase->QueryBounds(Broadphase::Grow(bounds, m_querySlack), candidates);
+		// the broadphases find the actors in the order they are stored in
+		std::sort(candidates.begin(), candidates.end());
+		checked = m_broadphaseCount;
+	}
+	for (unsigned int i = checked; i < m_actors.size(); i++)
+	{
+		candidates.push_back(i);
+	}
+
+	for (unsigned int index : candidates)
+	{
+		if (OverlapBox(m_actors[index], min, max))
+		{
+			actors.push_back(m_actors[index]);
+		}
+	}
+}
+void PhysicsScene::RaycastBatch(const std::vector<Ray>& rays, std::vector<RaycastHit>& hits)
+{
+	hits.resize(rays.size());
+
+	// the polys move their vertices to where they are now before the threads read them
+	for (PhysicsObject* actor : m_actors)
+	{
+		if (actor->GetShapeType() == POLY)
+		{
+			static_cast<Poly*>(actor)->UpdateWorldVertices();
+		}
+	}
+
+	// each ray only writes its own hit, so the threads don't need to wait for each other
+	auto castRays = [&](unsigned int begin, unsigned int end, unsigned int thread)
+	{
+		for (unsigned int i = begin; i < end; i++)
+		{
+			FindCastCandidates(rays[i].start, rays[i].end, 0.0f, m_queryCandidates[thread]);
+			CastCandidates(rays[i].start, rays[i].end, 0.0f, m_queryCandidates[thread], m_rayBatches[thread]);
+			GetNearestHit(m_rayBatches[thread], rays[i].start, rays[i].end, 0.0f, hits[i]);
+		}
+	};
+	if (m_workers != nullptr)
+	{
+		m_workers->ParallelFor(rays.size(), castRays);
+	}
+	else
+	{
+		castRays(0, rays.size(), 0);
+	}
+}
+
+void PhysicsScene::FindCastCandidates(const glm::vec2 & start, const glm::vec2 & end, const float radius, std::vector<unsigned int>& candidates) const
+{
+	candidates.clear();
+	unsigned int checked = 0;
+	if (m_broadphase != nullptr && m_broadphaseCount > 0)
+	{
+		m_broadphase->QueryRay(start, end, radius + m_querySlack, candidates);
+		checked = m_broadphaseCount;
+	}
+	// without a broadphase, or for the actors it hasn't seen yet, every actor is a candidate
+	for (unsigned int i = checked; i < m_actors.size(); i++)
+	{
+		candidates.push_back(i);
+	}
+}
+void PhysicsScene::CastCandidates(const glm::vec2 & start, const glm::vec2 & end, const float radius, const std::vector<unsigned int>& candidates, RayBatch & batch) const
+{
+	batch.Clear();
+	for (unsigned int index : candidates)
+	{
+		PhysicsObject* actor = m_actors[index];
+		switch (actor->GetShapeType())
+		{
+		case PLANE:
+			batch.AddPlane(index, static_cast<Plane*>(actor)->GetNormal(), static_cast<Plane*>(actor)->GetDistance());
+			break;
+		case SPHERE:
+			batch.AddCircle(index, static_cast<Sphere*>(actor)->GetPosition(), static_cast<Sphere*>(actor)->GetRadius());
+			break;
+		case BOX:
+			batch.AddBox(index, static_cast<AABB*>(actor)->GetMin(), static_cast<AABB*>(actor)->GetMax());
+			break;
+		case POLY:
+			batch.AddPoly(index, static_cast<Poly*>(actor)->GetWorldVertices(), static_cast<Poly*>(actor)->GetAxis());
+			break;
+		default:
+			break;
+		}
+	}
+	batch.Cast(start, end - start, radius);
+}
+RaycastHit PhysicsScene::MakeHit(const RayBatchHit & batchHit, const glm::vec2 & start, const glm::vec2 & end, const float radius) const
+{
+	RaycastHit hit;
+	hit.actor = m_actors[batchHit.shape];
+	hit.fraction = batchHit.fraction;
+	hit.normal = batchHit.normal;
+	// the centre of the circle is the radius away from the surface along the normal
+	hit.point = start + (end - start) * batchHit.fraction - batchHit.normal * radius;
+	return hit;
+}
+bool PhysicsScene::GetNearestHit(const RayBatch & batch, const glm::vec2 & start, const glm::vec2 & end, const float radius, RaycastHit & hit) const
+{
+	const RayBatchHit* nearest = nullptr;
+	for (unsigned int i = 0; i < batch.GetHitCount(); i++)
+	{
+		const RayBatchHit& batchHit = batch.GetHits()[i];
+		if (nearest == nullptr || batchHit.fraction < nearest->fraction ||
+			(batchHit.fraction == nearest->fraction && batchHit.shape < nearest->shape))
+		{
+			nearest = &batchHit;
+		}
+	}
+	if (nearest == nullptr)
+	{
+		hit.actor = nullptr;
+		hit.point = end;
+		hit.normal = glm::vec2(0.0f, 0.0f);
+		hit.fraction = 1.0f;
+		return false;
+	}
+	hit = MakeHit(*nearest, start, end, radius);
+	return true;
+}
 
-			// scales the normal by the impulse magnitude to get the resolution force
-			glm::vec2 force = normal * j;
+#pragma region Plane Collision
+// does nothing because planes don't collide
+bool PhysicsScene::Plane2Plane(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
+{
+	return false;
+}
+// swaps the order of the objects and passes them into the opposite function
+bool PhysicsScene::Plane2Sphere(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
+{
+	return Sphere2Plane(obj2, obj1, contact);
+}
+// swaps the order of the objects and passes them into the opposite function
+bool PhysicsScene::Plane2Box(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
+{
+	return Box2Plane(obj2, obj1, contact);
+}
+// swaps the order of the objects and passes them into the opposite function
+bool PhysicsScene::Plane2Poly(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
+{
+	return Poly2Plane(obj2, obj1, contact);
+}
+#pragma endregion
+
+#pragma region Sphere Collision
+bool PhysicsScene::Sphere2Plane(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
+{
+	// casts the objects to sphere and plane using their shape types
+	Sphere* sphere = ShapeCast<Sphere>(obj1);
+	Plane* plane = ShapeCast<Plane>(obj2);
+	// if successful then test for collision
+	if (sphere != nullptr && plane != nullptr)
+	{
+		// uses the plane's normal as the collision normal
+		glm::vec2 normal = plane->GetNormal();
+		// determines the distance between the circle and the plane
+		float sphereToPlane = glm::dot(sphere->GetPosition(), normal) - plane->GetDistance();
 
-			glm::vec2 contact = 0.5f * (sphere1->GetPosition() + sphere2->GetPosition());
+		// the amount the circle overlaps the plane
+		float overlap = sphere->GetRadius() - sphereToPlane;
+		// if the overlap amount is positive then a collision occurred, or the circle is close enough for a speculative contact
+		if (overlap >= -contact.margin)
+		{
+			// the plane's normal points towards the circle
+			contact.object1 = plane;
+			contact.object2 = sphere;
+			contact.normal = normal;
+			contact.overlap = overlap;
+			// the contact point is found by scaling the normal by the radius and taking that vector from the position
+			contact.point = sphere->GetPosition() - (normal * sphere->GetRadius());
+			return true;
+		}
+	}
 
-			// applys the friction force on each object if they are not static
-			if (!sphere1->GetStatic())
-			{
-				ApplyFriction(sphere1, -force, contact, gravity, timeStep, sphere2->GetStaticFriction(), sphere2->GetKineticFriction());
-			}
-			if (!sphere2->GetStatic())
-			{
-				ApplyFriction(sphere2, force, contact, gravity, timeStep, sphere1->GetStaticFriction(), sphere1->GetKineticFriction());
-			}
+	return false;
+}
+bool PhysicsScene::Sphere2Sphere(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
+{
+	// casts the objects to spheres using their shape types
+	Sphere* sphere1 = ShapeCast<Sphere>(obj1);
+	Sphere* sphere2 = ShapeCast<Sphere>(obj2);
+	// if successful then test for collision
+	if (sphere1 != nullptr && sphere2 != nullptr)
+	{
+		// determines the distance between the two circles
+		float distance = glm::distance(sphere1->GetPosition(), sphere2->GetPosition());
+		// sum of the two radii
+		float radii = sphere1->GetRadius() + sphere2->GetRadius();
 
+		// checks if the distance is less than the sum of the two radii, or close enough for a speculative contact
+		if (distance <= radii + contact.margin)
+		{
+			contact.object1 = sphere1;
+			contact.object2 = sphere2;
+			// the collision normal is the vector between the circles' positions
+			contact.normal = glm::normalize(sphere2->GetPosition() - sphere1->GetPosition());
+			// the amount the two circles overlap
+			contact.overlap = radii - distance;
+			contact.point = 0.5f * (sphere1->GetPosition() + sphere2->GetPosition());
 			return true;
 		}
 	}
 
 	return false;
 }
-bool PhysicsScene::Sphere2Box(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2& gravity, const float timeStep)
+bool PhysicsScene::Sphere2Box(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
 {
-	// try to cast objects to sphere and box
-	Sphere* sphere = dynamic_cast<Sphere*>(obj1);
-	AABB* box = dynamic_cast<AABB*>(obj2);
+	// casts the objects to sphere and box using their shape types
+	Sphere* sphere = ShapeCast<Sphere>(obj1);
+	AABB* box = ShapeCast<AABB>(obj2);
 	// if successful then test for collision
 	if (sphere != nullptr && box != nullptr)
 	{
 		// clamps the circle's position to the box's bounds, i.e. the closest point on the box relative to the circle
 		glm::vec2 clamp = glm::clamp(sphere->GetPosition(), box->GetMin(), box->GetMax());
+		glm::vec2 offset = sphere->GetPosition() - clamp;
+		float distance = glm::length(offset);
 		// if the distance between the closest point and the circle is less than the circle's radius then a collision occurred
-		if (glm::distance(clamp, sphere->GetPosition()) < sphere->GetRadius())
+		if (distance < sphere->GetRadius() + contact.margin)
 		{
-			// if either object is kinematic then there is no collision resolution
-			// if both objects are static then there will be no collision resolution because neither object will move
-			if (sphere->GetKinematic() || box->GetKinematic() || (sphere->GetStatic() && box->GetStatic()))
-			{
-				return true;
-			}
-
-			// the difference between the velocities is the relative velocity
-			glm::vec2 relativeVelocity = box->GetVelocity() - sphere->GetVelocity();
 			// the collision normal
-			glm::vec2 normal = glm::vec2(0.0f, 0.0f);
-
-			// collection of the corners of the AABB
-			std::vector<glm::vec2> corners = box->GetCorners();
-			// stores the corner closest to the circle
-			glm::vec2 closestCorner = normal;
-			// checks if the circle hit the corner of the box
-			for (glm::vec2 corner : corners)
-			{
-				// vector between the corner and the box
-				glm::vec2 v1 = glm::normalize(corner - box->GetPosition());
-				// vector between the circle and the box
-				glm::vec2 v2 = glm::normalize(sphere->GetPosition() - box->GetPosition());
-				// if the 2 vectors are very similar then use the vector from the circle to the box as the collision normal
-				if (glm::distance(v1, v2) < 0.05f)
-				{
-					normal = v2;
-					closestCorner = corner;
-					break;
-				}
-			}
-			// the circle did not hit the corner of the box, therefore the collision normal will be horizontal or vertical
-			if (normal == glm::vec2(0.0f, 0.0f))
-			{
-				// the collision normal between the circle and the box will be perpendicular to one of the box's sides
-				normal = glm::normalize(sphere->GetPosition() - clamp);
-			}
-
+			glm::vec2 normal;
 			// the amount the circle and box overlap
-			float overlap = 0.0f;
-			// checks if the circle's position is inside the box
-			if (glm::distance(clamp, sphere->GetPosition()) < 0.01f)
-			{
-				// checks if the collision normal is vertical or horizontal
-				if (normal.y == 0 || normal.x == 0)
-				{
-					// the absolute values of the collision normal
-					glm::vec2 absNormal = glm::vec2(fabsf(normal.x), fabsf(normal.y));
-					// gets the distance between the box's max position and the circle's min position
-					float o1 = glm::dot(absNormal, box->GetMax()) - glm::dot(absNormal, sphere->GetPosition() - (absNormal * sphere->GetRadius()));
-					// gets the distance between the box's min position and the circle's max position
-					float o2 = glm::dot(absNormal, sphere->GetPosition() + (absNormal * sphere->GetRadius())) - glm::dot(absNormal, box->GetMin());
-					// the smaller of the 2 distances is the overlap amount
-					overlap = (o1 < o2) ? o1 : o2;
-				}
-				// checks if the circle hit a corner
-				else if (closestCorner != glm::vec2(0.0f, 0.0f))
-				{
-					// flip the normal and scale it by the radius then add the vector to the circle's position to get the furthest point from the corner
-					glm::vec2 furthestPoint = sphere->GetPosition() - (normal * sphere->GetRadius());
-					// the distance between that point and the closest corner is the overlap amount
-					overlap = glm::distance(furthestPoint, closestCorner);
-				}
-			}
-			else // circle's center is not in the box
-			{
-				// scales the vector between the clamped position and the circle's center by the radius
-				glm::vec2 vectorViaClamp = normal * sphere->GetRadius();
-				// the overlap amount is the distance between the clamped position and the scaled clamped position
-				overlap = glm::distance(clamp, sphere->GetPosition() - vectorViaClamp);
-			}
-
-			// the individual momentums of the objects
-			float p1 = sphere->GetMass() * glm::length(sphere->GetVelocity());
-			float p2 = box->GetMass() * glm::length(box->GetVelocity());
-			// the sum of the two momentums
-			float momentum = p1 + p2;
-			// seperates the overlap based on the ratio of the momentums of the two objects
-			float overlap1 = overlap * (p2 / momentum);
-			float overlap2 = overlap * (p1 / momentum);
-
-			// uses the average elasticity of the two objects
-			float elasticity;
-			// "j" is the magnitude of the force vector that needs to be applied to the objects
-			float j;
-
-			// box to sphere restitution
-			// checks if both objects are not static
-			if (!sphere->GetStatic() && !box->GetStatic())
-			{
-				// determines which direction of velocity is away from the other object
-				if (glm::dot(sphere->GetVelocity() + (gravity * timeStep), normal) > 0.0f)
-				{
-					ApplyResitiution(sphere, sphere->GetVelocity() + (gravity * timeStep), normal, overlap1);
-				}
-				else
-				{
-					ApplyResitiution(sphere, -(sphere->GetVelocity() + (gravity * timeStep)), normal, overlap1);
-				}
-				if (glm::dot(box->GetVelocity() + (gravity * timeStep), -normal) > 0.0f)
-				{
-					ApplyResitiution(box, box->GetVelocity() + (gravity * timeStep), -normal, overlap2);
-				}
-				else
-				{
-					ApplyResitiution(box, -(box->GetVelocity() + (gravity * timeStep)), -normal, overlap2);
-				}
-
-				elasticity = (box->GetElasticity() + sphere->GetElasticity()) / 2.0f;
-				// the formula is: (j = (-(1 + e)v.rel)·n) / n·(n((1 / m.1) + (1 / m.2)))
-				j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * ((1 / box->GetMass()) + (1 / sphere->GetMass())));
-			}
-			// checks if only the sphere is not static
-			else if (!sphere->GetStatic())
+			float overlap;
+			// the circle's center is outside the box, the closest point is on a side or a corner and the normal points from it to the center
+			// this also works for long thin boxes, where the direction to a corner is close to the direction to most of a side
+			if (distance > 0.0f)
 			{
-				// gives the object the full overlap amount because the other object is static
-				if (glm::dot(sphere->GetVelocity() + (gravity * timeStep), normal) > 0.0f)
-				{
-					ApplyResitiution(sphere, sphere->GetVelocity() + (gravity * timeStep), normal, overlap);
-				}
-				else
-				{
-					ApplyResitiution(sphere, -(sphere->GetVelocity() + (gravity * timeStep)), normal, overlap);
-				}
-
-				// uses the elasticity of the sphere
-				elasticity = sphere->GetElasticity();
-				// the formula is: (j = (-(1 + e)v.rel)·n) / (1 / m), because the box has infinite mass when static
-				j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * (1 / sphere->GetMass()));
+				normal = offset / distance;
+				overlap = sphere->GetRadius() - distance;
 			}
-			// checks if only the box is not static
-			else if (!box->GetStatic())
+			// the circle's center is inside the box, so it is pushed out through the closest side
+			else
 			{
-				// gives the object the full overlap amount because the other object is static
-				if (glm::dot(box->GetVelocity() + (gravity * timeStep), -normal) > 0.0f)
+				glm::vec2 toMin = sphere->GetPosition() - box->GetMin();
+				glm::vec2 toMax = box->GetMax() - sphere->GetPosition();
+				float sideX = std::min(toMin.x, toMax.x);
+				float sideY = std::min(toMin.y, toMax.y);
+				if (sideX < sideY)
 				{
-					ApplyResitiution(box, box->GetVelocity() + (gravity * timeStep), -normal, overlap);
+					normal = glm::vec2((toMin.x < toMax.x) ? -1.0f : 1.0f, 0.0f);
+					overlap = sideX + sphere->GetRadius();
 				}
 				else
 				{
-					ApplyResitiution(box, -(box->GetVelocity() + (gravity * timeStep)), -normal, overlap);
+					normal = glm::vec2(0.0f, (toMin.y < toMax.y) ? -1.0f : 1.0f);
+					overlap = sideY + sphere->GetRadius();
 				}
-
-				// uses the elasticity of the box
-				elasticity = box->GetElasticity();
-				// the formula is: (j = (-(1 + e)v.rel)·n) / (1 / m), because the sphere has infinite mass when static
-				j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * (1 / box->GetMass()));
-			}
-
-			// scales the normal by the impulse magnitude to get the resolution force
-			glm::vec2 force = normal * j;
-
-			// applys the friction force on each object if the object is not static
-			if (!sphere->GetStatic())
-			{
-				ApplyFriction(sphere, -force, clamp, gravity, timeStep, box->GetStaticFriction(), box->GetKineticFriction());
-			}
-			if (!box->GetStatic())
-			{
-				ApplyFriction(box, force, clamp, gravity, timeStep, sphere->GetStaticFriction(), sphere->GetKineticFriction());
 			}
 
+			// the normal points from the box to the circle
+			contact.object1 = box;
+			contact.object2 = sphere;
+			contact.normal = normal;
+			contact.overlap = overlap;
+			contact.point = clamp;
 			return true;
 		}
 	}
@@ -525,30 +1381,30 @@ bool PhysicsScene::Sphere2Box(PhysicsObject * obj1, PhysicsObject * obj2, const
 	return false;
 }
 // swaps the order of the objects and passes them into the opposite function
-bool PhysicsScene::Sphere2Poly(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2 & gravity, const float timeStep)
+bool PhysicsScene::Sphere2Poly(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
 {
-	return Poly2Sphere(obj2, obj1, gravity, timeStep);
+	return Poly2Sphere(obj2, obj1, contact);
 }
 #pragma endregion
 
 #pragma region Box Collision
-bool PhysicsScene::Box2Plane(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2& gravity, const float timeStep)
+bool PhysicsScene::Box2Plane(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
 {
-	// try to cast objects to box and plane
-	AABB* box = dynamic_cast<AABB*>(obj1);
-	Plane* plane = dynamic_cast<Plane*>(obj2);
+	// casts the objects to box and plane using their shape types
+	AABB* box = ShapeCast<AABB>(obj1);
+	Plane* plane = ShapeCast<Plane>(obj2);
 	// if successful then test for collision
 	if (plane != nullptr && box != nullptr)
 	{
 		// collection of the corners of the box
-		std::vector<glm::vec2> corners = box->GetCorners();
+		std::array<glm::vec2, 4> corners = box->GetCorners();
 		// used to determine if the corner intersected with the plane
 		bool intersections[4] = { false };
 
 		for (unsigned int i = 0; i < 4; i++)
 		{
-			// checks if the corner is behind the plane
-			if (glm::dot(plane->GetNormal(), corners[i]) - plane->GetDistance() <= 0)
+			// checks if the corner is behind the plane, or close enough in front of it for a speculative contact
+			if (glm::dot(plane->GetNormal(), corners[i]) - plane->GetDistance() <= contact.margin)
 			{
 				// this corner intersects with the plane
 				intersections[i] = true;
@@ -558,21 +1414,12 @@ bool PhysicsScene::Box2Plane(PhysicsObject * obj1, PhysicsObject * obj2, const g
 		// if any of the corners intersect with the plane then a collision occurred
 		if (intersections[0] || intersections[1] || intersections[2] || intersections[3])
 		{
-			// if the either object is kinematic then there is no collision resolution
-			// if the box is static then there is no collision resolution because both objects will not move
-			if (box->GetKinematic() || plane->GetKinematic() || box->GetStatic())
-			{
-				return true;
-			}
-
 			// uses the plane's normal as the collision normal
 			glm::vec2 normal = plane->GetNormal();
-			// uses the box's velocity as the relative velocity
-			glm::vec2 relativeVelocity = box->GetVelocity();
 
 			// the amount the box overlaps the plane
-			float overlap = 0;
-			// from the intersecting corners, finds which one is furthest from the plane to determine the overlap amount
+			float overlap = std::numeric_limits<float>::max();
+			// from the intersecting corners, finds which one is furthest behind the plane to determine the overlap amount
 			for (int i = 0; i < 4; i++)
 			{
 				// checks if the corner is behind the plane
@@ -580,8 +1427,8 @@ bool PhysicsScene::Box2Plane(PhysicsObject * obj1, PhysicsObject * obj2, const g
 				{
 					// gets the corner's distance from the plane
 					float distance = glm::dot(corners[i], normal) - plane->GetDistance();
-					// checks if the distance is greater the currently stored overlap amount
-					if (fabsf(overlap) < fabsf(distance))
+					// checks if the corner is further behind than the currently stored overlap amount
+					if (distance < overlap)
 					{
 						// stores the distance as the new overlap
 						overlap = distance;
@@ -589,31 +1436,14 @@ bool PhysicsScene::Box2Plane(PhysicsObject * obj1, PhysicsObject * obj2, const g
 				}
 			}
 
-			// box to plane restitution
-			// determines which direction of velocity is away from the other object
-			if (glm::dot(box->GetVelocity() + (gravity * timeStep), normal) > 0.0f)
-			{
-				ApplyResitiution(box, box->GetVelocity() + (gravity * timeStep), normal, overlap);
-			}
-			else
-			{
-				ApplyResitiution(box, -(box->GetVelocity() + (gravity * timeStep)), normal, overlap);
-			}
-
-			// uses the box's elasticity
-			float elasticity = box->GetElasticity();
-			// "j" is the magnitude of the force vector that needs to be applied to the objects
-			// for planes the formula is: (j = (-(1 + e)v.rel)·n) / (1 / m)
-			float j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * (1 / box->GetMass()));
-
-			// scales the normal by the impulse magnitude to get the resolution force
-			glm::vec2 force = normal * j;
+			// the plane's normal points towards the box
+			contact.object1 = plane;
+			contact.object2 = box;
+			contact.normal = normal;
+			// the distance is negative behind the plane, the overlap is always positive
+			contact.overlap = -overlap;
 			// the contact point is the point on the box furthest down the normal
-			glm::vec2 contact = box->GetPosition() - (normal * overlap);
-
-			// applys the friction force on the object
-			ApplyFriction(box, force, contact, gravity, timeStep, plane->GetStaticFriction(), plane->GetKineticFriction());
-
+			contact.point = box->GetPosition() - (normal * overlap);
 			return true;
 		}
 	}
@@ -621,15 +1451,15 @@ bool PhysicsScene::Box2Plane(PhysicsObject * obj1, PhysicsObject * obj2, const g
 	return false;
 }
 // swaps the order of the objects and passes them into the opposite function
-bool PhysicsScene::Box2Sphere(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2& gravity, const float timeStep)
+bool PhysicsScene::Box2Sphere(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
 {
-	return Sphere2Box(obj2, obj1, gravity, timeStep);
+	return Sphere2Box(obj2, obj1, contact);
 }
-bool PhysicsScene::Box2Box(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2& gravity, const float timeStep)
+bool PhysicsScene::Box2Box(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
 {
-	// try to cast objects to boxes
-	AABB* box1 = dynamic_cast<AABB*>(obj1);
-	AABB* box2 = dynamic_cast<AABB*>(obj2);
+	// casts the objects to boxes using their shape types
+	AABB* box1 = ShapeCast<AABB>(obj1);
+	AABB* box2 = ShapeCast<AABB>(obj2);
 	// if successful then test for collision
 	if (box1 != nullptr && box2 != nullptr)
 	{
@@ -639,18 +1469,26 @@ bool PhysicsScene::Box2Box(PhysicsObject * obj1, PhysicsObject * obj2, const glm
 			box1->GetMax().x < box2->GetMin().x ||
 			box1->GetMax().y < box2->GetMin().y)
 		{
-			// no collision
-			return false;
-		}
-		else // collision occurred
-		{
-			// if either object is kinematic then there is no collision resolution
-			// if both objects are static then there will be no collision resolution because neither object will move
-			if (box1->GetKinematic() || box2->GetKinematic() || (box1->GetStatic() && box2->GetStatic()))
+			// the gaps between the boxes along each axis, the closest points are corners if there are gaps along both axes
+			glm::vec2 gap = glm::max(glm::max(box1->GetMin() - box2->GetMax(), box2->GetMin() - box1->GetMax()), glm::vec2(0.0f, 0.0f));
+			float distance = glm::length(gap);
+			// no collision, unless the boxes are close enough for a speculative contact
+			if (distance > contact.margin)
 			{
-				return true;
+				return false;
 			}
 
+			contact.object1 = box1;
+			contact.object2 = box2;
+			// the normal points across the gaps towards box2
+			contact.normal = gap * glm::sign(box2->GetPosition() - box1->GetPosition()) / distance;
+			contact.overlap = -distance;
+			// the closest point on box2 to box1
+			contact.point = glm::clamp(box1->GetPosition(), box2->GetMin(), box2->GetMax());
+			return true;
+		}
+		else // collision occurred
+		{
 			// the closest point on box2 to box1
 			glm::vec2 clamp = glm::clamp(box1->GetPosition(), box2->GetMin(), box2->GetMax());
 			glm::vec2 normal = glm::vec2(0.0f, 0.0f);
@@ -683,17 +1521,14 @@ bool PhysicsScene::Box2Box(PhysicsObject * obj1, PhysicsObject * obj2, const glm
 				normal = glm::normalize(box2->GetPosition() - box1->GetPosition());
 			}
 
-			// the difference between the velocities is the relative velocity
-			glm::vec2 relativeVelocity = box2->GetVelocity() - box1->GetVelocity();
-
 			// uses SAT to determine the overlap amount
 			// the smallest projection of box1 onto the normal
 			float min1 = std::numeric_limits<float>::max();
 			// the largest projection of box1 onto the normal
 			float max1 = std::numeric_limits<float>::lowest();
 			// the corners of box1
-			std::vector<glm::vec2> corners = box1->GetCorners();
-			for (glm::vec2 corner : corners)
+			std::array<glm::vec2, 4> corners = box1->GetCorners();
+			for (const glm::vec2& corner : corners)
 			{
 				// projects the corner onto the normal
 				float dot = glm::dot(corner, normal);
@@ -713,7 +1548,7 @@ bool PhysicsScene::Box2Box(PhysicsObject * obj1, PhysicsObject * obj2, const glm
 			float max2 = std::numeric_limits<float>::lowest();
 			// the corners of box2
 			corners = box2->GetCorners();
-			for (glm::vec2 corner : corners)
+			for (const glm::vec2& corner : corners)
 			{
 				// projects the corner onto the normal
 				float dot = glm::dot(corner, normal);
@@ -739,100 +1574,13 @@ bool PhysicsScene::Box2Box(PhysicsObject * obj1, PhysicsObject * obj2, const glm
 			{
 				overlap = max2 - min1;
 			}
-			
-			// the individual momentums of the boxes
-			float p1 = box1->GetMass() * glm::length(box1->GetVelocity());
-			float p2 = box2->GetMass() * glm::length(box2->GetVelocity());
-			// sum of the two momentums
-			float momentum = p1 + p2;
-			// seperates the overlap based on the ratio of the momentums of the two objects
-			float overlap1 = overlap * (p2 / momentum);
-			float overlap2 = overlap * (p1 / momentum);
-
-			// uses the average elasticity of the two objects
-			float elasticity;
-			// "j" is the magnitude of the force vector that needs to be applied to the objects
-			float j;
-
-			// box to box restitution
-			// checks if both objects are not static
-			if (!box1->GetStatic() && !box2->GetStatic())
-			{
-				// determines which direction of velocity is away from the other object
-				if (glm::dot(box1->GetVelocity() + (gravity * timeStep), -normal) > 0.0f)
-				{
-					ApplyResitiution(box1, box1->GetVelocity() + (gravity * timeStep), -normal, overlap1);
-				}
-				else
-				{
-					ApplyResitiution(box1, -(box1->GetVelocity() + (gravity * timeStep)), -normal, overlap1);
-				}
-				if (glm::dot(box2->GetVelocity() + (gravity * timeStep), normal) > 0.0f)
-				{
-					ApplyResitiution(box2, box2->GetVelocity() + (gravity * timeStep), normal, overlap2);
-				}
-				else
-				{
-					ApplyResitiution(box2, -(box2->GetVelocity() + (gravity * timeStep)), normal, overlap2);
-				}
-
-				// uses the average elasticity of the two objects
-				elasticity = (box1->GetElasticity() + box2->GetElasticity()) / 2.0f;
-				// the formula is: (j = (-(1 + e)v.rel)·n) / n·(n((1 / m.1) + (1 / m.2)))
-				j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * ((1 / box1->GetMass()) + (1 / box2->GetMass())));
-			}
-			// checks if only box1 is not static
-			else if (!box1->GetStatic())
-			{
-				// gives the object the full overlap amount because the other object is static
-				if (glm::dot(box1->GetVelocity() + (gravity * timeStep), -normal) > 0.0f)
-				{
-					ApplyResitiution(box1, box1->GetVelocity() + (gravity * timeStep), -normal, overlap);
-				}
-				else
-				{
-					ApplyResitiution(box1, -(box1->GetVelocity() + (gravity * timeStep)), -normal, overlap);
-				}
-
-				// uses the elasticity of box1
-				elasticity = box1->GetElasticity();
-				// the formula is: (j = (-(1 + e)v.rel)·n) / (1 / m), because box2 has infinite mass when static
-				j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * (1 / box1->GetMass()));
-			}
-			// checks if only box2 is not static
-			else if (!box2->GetStatic())
-			{
-				// gives the object the full overlap amount because the other object is static
-				if (glm::dot(box2->GetVelocity() + (gravity * timeStep), normal) > 0.0f)
-				{
-					ApplyResitiution(box2, box2->GetVelocity() + (gravity * timeStep), normal, overlap);
-				}
-				else
-				{
-					ApplyResitiution(box2, -(box2->GetVelocity() + (gravity * timeStep)), normal, overlap);
-				}
-
-				// uses the elasticity of box2
-				elasticity = box2->GetElasticity();
-				// the formula is: (j = (-(1 + e)v.rel)·n) / (1 / m), because box1 has infinite mass when static
-				j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * (1 / box2->GetMass()));
-			}
 
-			// scales the normal by the impulse magnitude to get the resolution force
-			glm::vec2 force = normal * j;
+			contact.object1 = box1;
+			contact.object2 = box2;
+			contact.normal = normal;
+			contact.overlap = overlap;
 			// the contact point is the point furthest away from box1 in the direction of box2
-			glm::vec2 contact = box1->GetPosition() - (normal * overlap);
-
-			// applys the friction force on each object if the object is not static
-			if (!box1->GetStatic())
-			{
-				ApplyFriction(box1, -force, contact, gravity, timeStep, box2->GetStaticFriction(), box2->GetKineticFriction());
-			}
-			if (!box2->GetStatic())
-			{
-				ApplyFriction(box2, force, contact, gravity, timeStep, box1->GetStaticFriction(), box1->GetKineticFriction());
-			}
-
+			contact.point = box1->GetPosition() - (normal * overlap);
 			return true;
 		}
 	}
@@ -840,18 +1588,18 @@ bool PhysicsScene::Box2Box(PhysicsObject * obj1, PhysicsObject * obj2, const glm
 	return false;
 }
 // swaps the order of the objects and passes them into the opposite function
-bool PhysicsScene::Box2Poly(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2 & gravity, const float timeStep)
+bool PhysicsScene::Box2Poly(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
 {
-	return Poly2Box(obj2, obj1, gravity, timeStep);
+	return Poly2Box(obj2, obj1, contact);
 }
 #pragma endregion
 
 #pragma region Poly Collision
-bool PhysicsScene::Poly2Plane(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2 & gravity, const float timeStep)
+bool PhysicsScene::Poly2Plane(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
 {
-	// try to cast objects to poly and plane
-	Poly* poly = dynamic_cast<Poly*>(obj1);
-	Plane* plane = dynamic_cast<Plane*>(obj2);
+	// casts the objects to poly and plane using their shape types
+	Poly* poly = ShapeCast<Poly>(obj1);
+	Plane* plane = ShapeCast<Plane>(obj2);
 	// if successful then test for collision
 	if (poly != nullptr && plane != nullptr)
 	{
@@ -866,52 +1614,23 @@ bool PhysicsScene::Poly2Plane(PhysicsObject * obj1, PhysicsObject * obj2, const
 			float overlap = projection.x - plane->GetDistance();
 			if (overlap <= 0.0f)
 			{
-				overlap = -overlap;
-
-				// if the either object is kinematic then there is no collision resolution
-				// if the poly is static then there is no collision resolution because both objects will not move
-				if (poly->GetKinematic() || plane->GetKinematic() || poly->GetStatic())
-				{
-					return true;
-				}
-
-				// uses the poly's velocity as the relative velocity
-				glm::vec2 relativeVelocity = poly->GetVelocity();
-
-				// poly to plane restitution
-				// determines which direction of velocity is away from the other object
-				if (glm::dot(relativeVelocity + (gravity * timeStep), normal) > 0.0f)
-				{
-					ApplyResitiution(poly, relativeVelocity + (gravity * timeStep), normal, overlap);
-				}
-				else
-				{
-					ApplyResitiution(poly, -(relativeVelocity + (gravity * timeStep)), normal, overlap);
-				}
-
-				// uses the elasticity of the poly
-				float elasticity = poly->GetElasticity();
-				// "j" is the magnitude of the force vector that needs to be applied to the objects
-				// for planes the formula is: (j = (-(1 + e)v.rel)·n) / (1 / m)
-				float j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * (1 / poly->GetMass()));
-
-				// scales the normal by the impulse magnitude to get the resolution force
-				glm::vec2 force = normal * j;
-				glm::vec2 contact = glm::vec2(0.0f, 0.0f);
-
-				// finds the point that was moveed to the edge of the plane
-				for (glm::vec2 vertex : poly->GetVertices())
+				// the plane's normal points towards the poly
+				contact.object1 = plane;
+				contact.object2 = poly;
+				contact.normal = normal;
+				contact.overlap = -overlap;
+
+				// the contact point is the vertex furthest behind the plane
+				float min = std::numeric_limits<float>::max();
+				for (const glm::vec2& vertex : poly->GetWorldVertices())
 				{
-					if (glm::dot(vertex + poly->GetPosition(), normal) - plane->GetDistance() == 0.0f)
+					float distance = glm::dot(vertex, normal);
+					if (distance < min)
 					{
-						contact = vertex + poly->GetPosition();
-						break;
+						min = distance;
+						contact.point = vertex;
 					}
 				}
-
-				// applys the friction force to the object
-				ApplyFriction(poly, force, contact, gravity, timeStep, plane->GetStaticFriction(), plane->GetKineticFriction());
-
 				return true;
 			}
 		}
@@ -919,205 +1638,203 @@ bool PhysicsScene::Poly2Plane(PhysicsObject * obj1, PhysicsObject * obj2, const
 
 	return false;
 }
-bool PhysicsScene::Poly2Sphere(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2 & gravity, const float timeStep)
+bool PhysicsScene::Poly2Sphere(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
 {
+	// casts the objects to poly and circle using their shape types
+	Poly* poly = ShapeCast<Poly>(obj1);
+	Sphere* sphere = ShapeCast<Sphere>(obj2);
+	// if successful then test for collision
+	if (poly != nullptr && sphere != nullptr)
+	{
+		// checks if the circle is within the distance of the poly's furthest vertex before doing the full check
+		if (glm::distance(poly->GetPosition(), sphere->GetPosition()) <= poly->GetRadius() + sphere->GetRadius())
+		{
+			// GJK finds the normal, overlap and deepest point
+			return GJK::Collide(poly, sphere, contact.axis, contact);
+		}
+	}
+
 	return false;
 }
-bool PhysicsScene::Poly2Box(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2 & gravity, const float timeStep)
+bool PhysicsScene::Poly2Box(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
 {
+	// casts the objects to poly and box using their shape types
+	Poly* poly = ShapeCast<Poly>(obj1);
+	AABB* box = ShapeCast<AABB>(obj2);
+	// if successful then test for collision
+	if (poly != nullptr && box != nullptr)
+	{
+		// checks if the box is within the distance of the poly's furthest vertex before doing the full check
+		if (glm::distance(poly->GetPosition(), box->GetPosition()) <= poly->GetRadius() + glm::length(box->GetExtents()))
+		{
+			// GJK finds the normal, overlap and deepest point
+			return GJK::Collide(poly, box, contact.axis, contact);
+		}
+	}
+
 	return false;
 }
-bool PhysicsScene::Poly2Poly(PhysicsObject * obj1, PhysicsObject * obj2, const glm::vec2 & gravity, const float timeStep)
+bool PhysicsScene::Poly2Poly(PhysicsObject * obj1, PhysicsObject * obj2, Contact& contact)
 {
-	// try to cast objects to poly and poly
-	Poly* poly1 = dynamic_cast<Poly*>(obj1);
-	Poly* poly2 = dynamic_cast<Poly*>(obj2);
+	// casts the objects to poly and poly using their shape types
+	Poly* poly1 = ShapeCast<Poly>(obj1);
+	Poly* poly2 = ShapeCast<Poly>(obj2);
 	// if successful then test for collision
 	if (poly1 != nullptr && poly2 != nullptr)
 	{
 		// performs a circle to circle collision check using the distance of the poly's furthest vertex as a radius
 		// this is to check if the two objects are worth checking for collision
-		if (glm::distance(poly1->GetPosition(), poly2->GetPosition()) <= poly1->GetRadius() + poly2->GetRadius())
+		if (glm::distance(poly1->GetPosition(), poly2->GetPosition()) <= poly1->GetRadius() + poly2->GetRadius() + contact.margin)
 		{
-			// the overlap amount between the two objects
-			float overlap = std::numeric_limits<float>::max();
-			// collision normal
-			glm::vec2 normal = glm::vec2(0.0f, 0.0f);
-			// gets a collection of potential collision normals from both objects
-			std::vector<glm::vec2> axis1 = poly1->GetAxis();
-			std::vector<glm::vec2> axis2 = poly2->GetAxis();
-			
-			for (glm::vec2 axis : axis1)
-			{
-				// projects both objects onto the axis
-				glm::vec2 proj1 = poly1->Project(axis);
-				glm::vec2 proj2 = poly2->Project(axis);
-
-				// checks if the two projections do not overlap
-				if (!poly1->Overlap(proj1, proj2))
-				{
-					// there is no collision
-					return false;
-				}
-				else
-				{
-					// gets the overlap amount and stores it if it is less than the current overlap amount
-					float o = poly1->GetOverlap(proj1, proj2);
-					if (o < overlap)
-					{
-						overlap = o;
-						// stores the axis as the current collision normal
-						normal = axis;
-					}
-				}
-			}
-
-			for (glm::vec2 axis : axis2)
+			// GJK finds the normal and overlap, which is cheaper than projecting every vertex onto every edge normal
+			if (!GJK::Collide(poly1, poly2, contact.axis, contact))
 			{
-				// projects both objects onto the axis
-				glm::vec2 proj1 = poly1->Project(axis);
-				glm::vec2 proj2 = poly2->Project(axis);
-
-				// checks if the two projections do not overlap
-				if (!poly1->Overlap(proj1, proj2))
+				// polys that are apart can still be close enough for a speculative contact between their closest points
+				ConvexDistance closest;
+				if (contact.margin <= 0.0f || !GJK::Distance(poly1, poly2, contact.axis, contact.margin, closest) || closest.distance > contact.margin)
 				{
-					// there is no collision
 					return false;
 				}
-				else
-				{
-					// gets the overlap amount and stores it if it is less than the current overlap amount
-					float o = poly1->GetOverlap(proj1, proj2);
-					if (o < overlap)
-					{
-						overlap = o;
-						// stores the axis as the current collision normal
-						normal = axis;
-					}
-				}
+				contact.object1 = poly1;
+				contact.object2 = poly2;
+				contact.normal = closest.normal;
+				contact.overlap = -closest.distance;
+				contact.point = 0.5f * (closest.point1 + closest.point2);
+				return true;
 			}
 
-			// if either object is kinematic then there is no collision resolution
-			// if both objects are static then there will be no collision resolution because neither object will move
-			if (poly1->GetKinematic() || poly2->GetKinematic() || (poly1->GetStatic() && poly2->GetStatic()))
+			// the contact manifold is only needed if the collision will be resolved
+			if (!CanResolve(poly1, poly2))
 			{
 				return true;
 			}
 
-			// the difference between the velocities is the relative velocity
-			glm::vec2 relativeVelocity = poly2->GetVelocity() - poly1->GetVelocity();
-			float p1 = poly1->GetMass() * glm::length(poly1->GetVelocity());
-			float p2 = poly2->GetMass() * glm::length(poly2->GetVelocity());
-			// sum of the two masses
-			float momentum = p1 + p2;
-			// seperates the overlap based on the ratio of the masses of the two objects
-			float overlap1 = overlap * (p2 / momentum);
-			float overlap2 = overlap * (p1 / momentum);
-
-			// uses the average elasticity of the two objects
-			float elasticity;
-			// "j" is the magnitude of the force vector that needs to be applied to the objects
-			float j;
-
-			// box to box restitution
-			// checks if both objects are not static
-			if (!poly1->GetStatic() && !poly2->GetStatic())
+			// gets the contact manifold, GJK's deepest point is kept if the edges can't be clipped
+			ScratchArray<glm::vec2> contactPoints = poly1->ContactPoints(poly2, contact.normal);
+			if (contactPoints.size() > 0)
 			{
-				// determines which direction of velocity is away from the other object
-				if (glm::dot(poly1->GetVelocity() + (gravity * timeStep), -normal) > 0.0f)
-				{
-					ApplyResitiution(poly1, poly1->GetVelocity() + (gravity * timeStep), -normal, overlap1);
-				}
-				else
-				{
-					ApplyResitiution(poly1, -(poly1->GetVelocity() + (gravity * timeStep)), -normal, overlap1);
-				}
-				if (glm::dot(poly2->GetVelocity() + (gravity * timeStep), normal) > 0.0f)
-				{
-					ApplyResitiution(poly2, poly2->GetVelocity() + (gravity * timeStep), normal, overlap2);
-				}
-				else
+				// sets the contact point as the average point of the contact manifold
+				contact.point = glm::vec2(0.0f, 0.0f);
+				for (glm::vec2 point : contactPoints)
 				{
-					ApplyResitiution(poly2, -(poly2->GetVelocity() + (gravity * timeStep)), normal, overlap2);
+					contact.point += point;
 				}
-
-				elasticity = (poly1->GetElasticity() + poly2->GetElasticity()) / 2.0f;
-				// the formula is: (j = (-(1 + e)v.rel)·n) / n·(n((1 / m.1) + (1 / m.2)))
-				j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * ((1 / poly1->GetMass()) + (1 / poly2->GetMass())));
+				contact.point /= contactPoints.size();
 			}
-			// checks if only poly1 is not static
-			else if (!poly1->GetStatic())
-			{
-				// gives the object the full overlap amount because the other object is static
-				if (glm::dot(poly1->GetVelocity() + (gravity * timeStep), -normal) > 0.0f)
-				{
-					ApplyResitiution(poly1, poly1->GetVelocity() + (gravity * timeStep), -normal, overlap);
-				}
-				else
-				{
-					ApplyResitiution(poly1, -(poly1->GetVelocity() + (gravity * timeStep)), -normal, overlap);
-				}
 
-				// uses the elasticity of poly1
-				elasticity = poly1->GetElasticity();
-				// the formula is: (j = (-(1 + e)v.rel)·n) / (1 / m), because poly2 has infinite mass when static
-				j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * (1 / poly1->GetMass()));
-			}
-			// checks if only poly2 is not static
-			else if (!poly2->GetStatic())
-			{
-				// gives the object the full overlap amount because the other object is static
-				if (glm::dot(poly2->GetVelocity() + (gravity * timeStep), normal) > 0.0f)
-				{
-					ApplyResitiution(poly2, poly2->GetVelocity() + (gravity * timeStep), normal, overlap);
-				}
-				else
-				{
-					ApplyResitiution(poly2, -(poly2->GetVelocity() + (gravity * timeStep)), normal, overlap);
-				}
+			return true;
+		}
+	}
 
-				// uses the elasticity of poly2
-				elasticity = poly2->GetElasticity();
-				// the formula is: (j = (-(1 + e)v.rel)·n) / (1 / m), because poly1 has infinite mass when static
-				j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * (1 / poly2->GetMass()));
-			}
+	return false;
+}
+#pragma endregion
 
-			// scales the normal by the impulse magnitude to get the resolution force
-			glm::vec2 force = normal * j;
+void PhysicsScene::ResolveContact(const Contact & contact, const glm::vec2 & gravity, const float timeStep)
+{
+	// if either object is kinematic then there is no collision resolution
+	// if both objects are static then there will be no collision resolution because neither object will move
+	if (!CanResolve(contact.object1, contact.object2))
+	{
+		return;
+	}
 
-			// gets the contact manifold
-			std::vector<glm::vec2> contactPoints = poly1->ContactPoints(poly2, normal);
-			glm::vec2 contact = glm::vec2(0.0f, 0.0f);
-			// checks if there is no contact point given
-			if (contactPoints.size() == 0)
-			{
-				return false;
-			}
+	// every shape except planes is a rigidbody, planes are treated as static objects that don't move
+	Rigidbody* body1 = (contact.object1->GetShapeType() != PLANE) ? static_cast<Rigidbody*>(contact.object1) : nullptr;
+	Rigidbody* body2 = (contact.object2->GetShapeType() != PLANE) ? static_cast<Rigidbody*>(contact.object2) : nullptr;
+	bool static1 = (body1 == nullptr || body1->GetStatic());
+	bool static2 = (body2 == nullptr || body2->GetStatic());
 
-			// sets the contact point as the average point of the contact manifold
-			for each (glm::vec2 point in contactPoints)
-			{
-				contact += point;
-			}
-			contact /= contactPoints.size();
+	glm::vec2 normal = contact.normal;
+	glm::vec2 velocity1 = (body1 != nullptr) ? body1->GetVelocity() : glm::vec2(0.0f, 0.0f);
+	glm::vec2 velocity2 = (body2 != nullptr) ? body2->GetVelocity() : glm::vec2(0.0f, 0.0f);
+	// the difference between the velocities is the relative velocity
+	glm::vec2 relativeVelocity = velocity2 - velocity1;
 
-			// applys the friction force on each object if the object is not static
-			if (!poly1->GetStatic())
-			{
-				ApplyFriction(poly1, -force, contact, gravity, timeStep, poly2->GetStaticFriction(), poly2->GetKineticFriction());
-			}
-			if (!poly2->GetStatic())
-			{
-				ApplyFriction(poly2, force, contact, gravity, timeStep, poly1->GetStaticFriction(), poly1->GetKineticFriction());
-			}
+	// a speculative contact is only resolved if the objects would overlap by the next step, and they aren't moved together
+	if (contact.overlap < 0.0f && glm::dot(relativeVelocity, normal) * timeStep >= contact.overlap)
+	{
+		return;
+	}
+	float overlap = fmaxf(contact.overlap, 0.0f);
 
-			return true;
-		}
+	// uses the average elasticity of the two objects
+	float elasticity;
+	// "j" is the magnitude of the force vector that needs to be applied to the objects
+	float j;
+
+	// checks if both objects are not static
+	if (!static1 && !static2)
+	{
+		// the individual momentums of the objects
+		float p1 = body1->GetMass() * glm::length(velocity1);
+		float p2 = body2->GetMass() * glm::length(velocity2);
+		// the sum of the two momentums
+		float momentum = p1 + p2;
+		// seperates the overlap based on the ratio of the momentums of the two objects
+		ApplyResitiution(body1, -normal, overlap * (p2 / momentum));
+		ApplyResitiution(body2, normal, overlap * (p1 / momentum));
+
+		elasticity = (body1->GetElasticity() + body2->GetElasticity()) / 2.0f;
+		// the formula is: (j = (-(1 + e)v.rel)·n) / n·(n((1 / m.1) + (1 / m.2)))
+		j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * ((1 / body1->GetMass()) + (1 / body2->GetMass())));
 	}
+	// checks if only the first object is not static
+	else if (!static1)
+	{
+		// gives the object the full overlap amount because the other object is static
+		ApplyResitiution(body1, -normal, overlap);
 
-	return false;
+		// uses the elasticity of the first object
+		elasticity = body1->GetElasticity();
+		// the formula is: (j = (-(1 + e)v.rel)·n) / (1 / m), because the second object has infinite mass when static
+		j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * (1 / body1->GetMass()));
+	}
+	// only the second object is not static
+	else
+	{
+		// gives the object the full overlap amount because the other object is static
+		ApplyResitiution(body2, normal, overlap);
+
+		// uses the elasticity of the second object
+		elasticity = body2->GetElasticity();
+		// the formula is: (j = (-(1 + e)v.rel)·n) / (1 / m), because the first object has infinite mass when static
+		j = glm::dot(-(1 + elasticity) * (relativeVelocity), normal) / glm::dot(normal, normal * (1 / body2->GetMass()));
+	}
+
+	// the objects of a speculative contact can still close the gap, so they don't bounce and only the speed on top of that is
+	// removed, they land on each other the same as with the contact solver
+	if (contact.overlap < 0.0f)
+	{
+		float normalVelocity = glm::dot(relativeVelocity, normal);
+		j *= (normalVelocity - contact.overlap / timeStep) / ((1 + elasticity) * normalVelocity);
+	}
+
+	// scales the normal by the impulse magnitude to get the resolution force
+	glm::vec2 force = normal * j;
+
+	// applys the friction force on each object if they are not static
+	if (!static1)
+	{
+		ApplyFriction(body1, -force, contact.point, gravity, timeStep, contact.object2->GetStaticFriction(), contact.object2->GetKineticFriction());
+	}
+	if (!static2)
+	{
+		ApplyFriction(body2, force, contact.point, gravity, timeStep, contact.object1->GetStaticFriction(), contact.object1->GetKineticFriction());
+	}
+}
+bool PhysicsScene::CanResolve(const PhysicsObject * obj1, const PhysicsObject * obj2)
+{
+	if (obj1->GetKinematic() || obj2->GetKinematic())
+	{
+		return false;
+	}
+
+	// planes are always static
+	bool static1 = (obj1->GetShapeType() == PLANE || static_cast<const Rigidbody*>(obj1)->GetStatic());
+	bool static2 = (obj2->GetShapeType() == PLANE || static_cast<const Rigidbody*>(obj2)->GetStatic());
+	return !(static1 && static2);
 }
-#pragma endregion
 
 void PhysicsScene::ApplyFriction(Rigidbody * obj, const glm::vec2 & force, const glm::vec2& contact, const glm::vec2 gravity, const float timeStep, const float µs, const float µk)
 {
@@ -1162,38 +1879,15 @@ void PhysicsScene::ApplyFriction(Rigidbody * obj, const glm::vec2 & force, const
 	}
 }
 
-void PhysicsScene::ApplyResitiution(Rigidbody * obj, const glm::vec2 & velocity, const glm::vec2 & normal, const float overlap)
+void PhysicsScene::ApplyResitiution(Rigidbody * obj, const glm::vec2 & normal, const float overlap)
 {
-	const float HALF_PI = acosf(0.0f);
-	// the amount either side of an angle that would result in an issue with finding tan of that angle
-	const float TOLERANCE = 0.000001f;
-
-	float theta = 0.0f;
-	// checks if the object is moving
-	if (glm::length(velocity) != 0.0f)
-	{
-		// the angle between the velocity and collision normal
-		theta = acosf(fminf(glm::dot(glm::normalize(velocity), normal), 1.0f));
-		// the amount the box needs to move perpendicular to the collision normal
-		float perpendicular = 0.0f;
-		// ensures that the value is not 90 or 270 degrees to the normal
-		if ((theta > HALF_PI + TOLERANCE && theta < (HALF_PI * 3.0f) - TOLERANCE) || theta > (HALF_PI * 3.0f) + TOLERANCE || theta <= HALF_PI - TOLERANCE)
-		{
-			perpendicular = tanf(theta) * overlap;
-		}
-		// multiplies the velocity in the opposite direction by the magnitude of the vector at ("perpendicular", "overlap")
-		glm::vec2 restitution = glm::length(glm::vec2(perpendicular, overlap)) * glm::normalize(velocity);
-		// adds the restitution to the current object's position
-		obj->SetPosition(obj->GetPosition() + restitution);
-	}
-	else // the object is not moving
-	{
-		// the amount the box needs to move perpendicular to the collision normal
-		float perpendicular = overlap;
-		// multiplies the velocity in the opposite direction by the magnitude of the vector at ("perpendicular", "overlap")
-		// because the object is stationary the normal will be used to determine restitution direction
-		glm::vec2 restitution = glm::length(glm::vec2(perpendicular, overlap)) * glm::normalize(normal);
-		// adds the restitution to the current object's position
-		obj->SetPosition(obj->GetPosition() + restitution);
+	// speculative contacts and objects that are only just touching have no overlap, so there is nothing to move
+	if (overlap == 0.0f)
+	{
+		return;
 	}
+
+	// the overlap is measured along the normal, so moving the object the same distance along the normal is enough to separate it
+	// moving along the normal instead of the velocity also stops a glancing hit from sliding the object along the surface
+	obj->SetPosition(obj->GetPosition() + (normal * overlap));
 }
\ No newline at end of file
@@ -3,6 +3,26 @@
 #include <vector>
 #include "PhysicsObject.h"
 #include "Rigidbody.h"
+#include "Broadphase.h"
+#include "BodyStore.h"
+#include "Contact.h"
+#include "WorkerPool.h"
+#include "ContactSolver.h"
+#include "GJKCache.h"
+#include "SphereBatch.h"
+#include "RayBatch.h"
+#include "ContactEvents.h"
+#include "UnionFind.h"
+#include "StepArena.h"
+
+// where a handle's actor is kept in the scene
+struct ActorSlot
+{
+	// the index of the actor in the scene, or the next free slot if the slot isn't being used
+	unsigned int actor;
+	// incremented each time the slot's actor is removed so the old handles stop working
+	unsigned int generation;
+};
 
 class PhysicsScene
 {
@@ -11,13 +31,21 @@ public:
 	PhysicsScene(const glm::vec2& gravity, const float timeStep);
 	~PhysicsScene();
 
-	// adds an actor
-	void AddActor(PhysicsObject* actor);
-	// removes an actor
+	// adds an actor, the handle can be kept instead of the pointer to find out if the actor has been removed
+	// adding an actor that is already in the scene gives back its handle
+	ActorHandle AddActor(PhysicsObject* actor);
+	// removes an actor, the last actor is moved into its place so the order of the actors changes
+	// returns false if the actor isn't in the scene, actors removed during a step are removed once the step has finished
 	bool RemoveActor(PhysicsObject* actor);
+	bool RemoveActor(const ActorHandle& handle);
+	// gets the actor the handle refers to, null if the actor has been removed
+	PhysicsObject* GetActor(const ActorHandle& handle) const;
+	// checks if the actor has been added to this scene and not removed
+	bool Contains(const PhysicsObject* actor) const;
+	unsigned int GetActorCount() const { return m_actors.size(); }
 	// calls the update function on all actors
 	void Update(const float dt);
-	// updates all the actor's gizmos
+	// updates all the actor's gizmos, drawn between the last two fixed steps so the time step can be longer than a frame
 	void UpdateGizmos();
 	// calls the debug function of each actor
 	void DebugScene();
@@ -26,52 +54,106 @@ public:
 	glm::vec2 GetGravity() const { return m_gravity; }
 	void SetTimeStep(const float timeStep) { m_timeStep = timeStep; }
 	float GetTimeStep() const { return m_timeStep; }
+	// the amount of heap allocations made by any thread during the last call to Update, 0 once the scene has warmed up
+	// always 0 unless PHYSICS_ALLOCATION_COUNTER is defined, see AllocationCounter
+	unsigned long long GetStepAllocations() const { return m_stepAllocations; }
+	// the most fixed steps that are run in one call to Update, 0 for no limit
+	// stops a long frame from making the next frame even longer by having to catch up
+	void SetMaxSubSteps(const unsigned int maxSubSteps) { m_maxSubSteps = maxSubSteps; }
+	unsigned int GetMaxSubSteps() const { return m_maxSubSteps; }
+	// how far the scene is between the last fixed step and the next one, from 0 to 1
+	float GetAlpha() const { return m_accumulatedTime / m_timeStep; }
+	// changes the algorithm used to find which actors might be colliding, the result is the same as checking every pair except
+	// with the immediate solver on 1 thread, where each pair is checked after the pairs before it were resolved
+	void SetBroadphase(const BroadphaseType broadphaseType);
+	BroadphaseType GetBroadphase() const { return m_broadphaseType; }
+	// stores the state of the rigidbodies in contiguous arrays so they can all be integrated in one pass
+	void SetBodyStorage(const bool enabled);
+	bool GetBodyStorage() const { return m_bodyStore != nullptr; }
+	// changes how the contacts are resolved, the sequential impulse solver keeps stacks stable with a much longer time step
+	void SetSolver(const SolverType solverType);
+	SolverType GetSolver() const { return m_solverType; }
+	// used to change the iterations, position correction and warm starting of the sequential impulse solver
+	ContactSolver& GetContactSolver() { return m_contactSolver; }
+	// the directions GJK finished with for each pair of convex shapes, used to see how often the searches are warm started
+	GJKCache& GetGJKCache() { return m_gjkCache; }
+	// the begin, stay and end events of the pairs that touched during the last update, nothing is written until it has a capacity
+	ContactEventStream& GetContactEvents() { return m_contactEvents; }
+	// finds contacts between shapes that are close enough to touch during the next step, so fast objects don't pass through
+	// each other (speculative contacts)
+	void SetSpeculativeContacts(const bool speculative) { m_speculative = speculative; }
+	bool GetSpeculativeContacts() const { return m_speculative; }
+	// the distance the shapes can be apart on top of how far they move towards each other in a step and still make a contact
+	void SetSpeculativeMargin(const float margin) { m_speculativeMargin = margin; }
+	float GetSpeculativeMargin() const { return m_speculativeMargin; }
+	// lets groups of touching rigidbodies fall asleep together once they have been resting for long enough
+	void SetSleeping(const bool sleeping);
+	bool GetSleeping() const { return m_sleeping; }
+	// splits the step across a pool of threads, 1 runs everything on the calling thread
+	// with more than 1 thread every contact is found before any are resolved, so the result is the same for any amount of threads
+	void SetThreadCount(const unsigned int threadCount);
+	unsigned int GetThreadCount() const { return (m_workers != nullptr) ? m_workers->GetThreadCount() : 1; }
 
 	// checks if any actors are colliding with each other
 	void CheckForCollision();
 
+	// the queries use the broadphase from the end of the last step and can't be made during a step
+	// finds the first actor that the segment from start to end passes into, false if it doesn't hit anything
+	bool Raycast(const glm::vec2& start, const glm::vec2& end, RaycastHit& hit);
+	// finds every actor that the segment passes into, sorted from the nearest to the furthest
+	void RaycastAll(const glm::vec2& start, const glm::vec2& end, std::vector<RaycastHit>& hits);
+	// finds the first actor that a circle of the radius moving from start to end touches
+	bool CircleCast(const glm::vec2& start, const glm::vec2& end, const float radius, RaycastHit& hit);
+	// finds every actor that overlaps or touches the box from min to max, in the order they are in the scene
+	void OverlapAABB(const glm::vec2& min, const glm::vec2& max, std::vector<PhysicsObject*>& actors);
+	// finds the first actor that each ray hits and writes it to the same index of the hits, the actor is null if it hits nothing
+	// the rays are split between the threads of the scene, the hits are the same for any amount of threads
+	void RaycastBatch(const std::vector<Ray>& rays, std::vector<RaycastHit>& hits);
+
+	// the collision functions check if the two objects are colliding and fill in the contact if they are
+
 #pragma region Plane Collision
 	// checks for collision between plane and plane
-	static bool Plane2Plane(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Plane2Plane(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 	// does the reverse of a circle to plane collision check
-	static bool Plane2Sphere(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Plane2Sphere(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 	// does the reverse of a box to plane collision check
-	static bool Plane2Box(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Plane2Box(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 	// does the reverse of a poly to plane collision check
-	static bool Plane2Poly(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Plane2Poly(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 #pragma endregion
 
 #pragma region Sphere Collision
 	// checks for collision between circle and plane
-	static bool Sphere2Plane(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Sphere2Plane(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 	// checks for collision between box and plane
-	static bool Sphere2Sphere(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Sphere2Sphere(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 	// checks for collision between circle and box
-	static bool Sphere2Box(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Sphere2Box(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 	// does the reverse of a poly to circle collision check
-	static bool Sphere2Poly(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Sphere2Poly(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 #pragma endregion
 
 #pragma region Box Collision
 	// checks for collision between box and plane
-	static bool Box2Plane(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Box2Plane(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 	// does the reverse of a cirlce to box collision check
-	static bool Box2Sphere(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Box2Sphere(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 	// cheks for collision between box and box
-	static bool Box2Box(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Box2Box(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 	// does the reverse of a poly to box collision check
-	static bool Box2Poly(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Box2Poly(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 #pragma endregion
 
 #pragma region Poly Collision
 	// cheks for collision between poly and plane
-	static bool Poly2Plane(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Poly2Plane(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 	// cheks for collision between poly and circle
-	static bool Poly2Sphere(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Poly2Sphere(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 	// cheks for collision between poly and box
-	static bool Poly2Box(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Poly2Box(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 	// cheks for collision between poly and poly
-	static bool Poly2Poly(PhysicsObject* obj1, PhysicsObject* obj2, const glm::vec2& gravity, const float timeStep);
+	static bool Poly2Poly(PhysicsObject* obj1, PhysicsObject* obj2, Contact& contact);
 #pragma endregion
 
 #pragma region Apply Friction Parameters
@@ -85,14 +167,124 @@ public:
 #pragma endregion
 	// applies a friction force to the object
 	static void ApplyFriction(Rigidbody* obj, const glm::vec2& force, const glm::vec2& contact, const glm::vec2 gravity, const float timeStep, const float s, const float k);
-	// restitutes the object based on its velocity
-	static void ApplyResitiution(Rigidbody* obj, const glm::vec2& velocity, const glm::vec2& normal, const float overlap);
+	// moves the object out of the other object along the collision normal
+	static void ApplyResitiution(Rigidbody* obj, const glm::vec2& normal, const float overlap);
+	// moves the objects in the contact apart and applies the resolution and friction forces
+	static void ResolveContact(const Contact& contact, const glm::vec2& gravity, const float timeStep);
+	// checks if either object would be moved by resolving a collision between them
+	static bool CanResolve(const PhysicsObject* obj1, const PhysicsObject* obj2);
+
+protected:
+	// removes the actors that were removed during the step
+	void RemovePendingActors();
+	// passes the two objects into the collision function for their shapes
+	// the pairs that use GJK start from the direction they finished with last step, the thread is the one checking the pair
+	bool FindContact(PhysicsObject* object1, PhysicsObject* object2, Contact& contact, const unsigned int thread);
+	// checks if the collision function for the two objects uses GJK
+	static bool UsesGJK(const PhysicsObject* object1, const PhysicsObject* object2);
+	// adds the pairs of circles from begin up to but not including end of the broadphase pairs to the batch and filters them
+	// only the pairs left in the batch need to be passed to Sphere2Sphere, the positions can't change until they have been
+	void FilterSpheres(const unsigned int begin, const unsigned int end, SphereBatch& batch) const;
+	// checks if both objects are spheres
+	static bool IsSpherePair(const PhysicsObject* object1, const PhysicsObject* object2);
+	// how far apart the objects can be and still make a contact, 0 unless speculative contacts are used
+	float GetSpeculativeDistance(const PhysicsObject* object1, const PhysicsObject* object2) const;
+	// finds the collision between the two objects and resolves it, or stores it for the solver
+	bool CheckForCollision(PhysicsObject* object1, PhysicsObject* object2);
+	// finds the contacts on every thread and then resolves them in the order of the pairs if the solver isn't used
+	void CheckForCollisionParallel();
+	// checks if the object is a rigidbody that is awake and can be moved
+	static bool IsActive(const PhysicsObject* obj);
+	// checks if the object is a rigidbody that can be moved by collisions, only these are joined into islands
+	static bool IsDynamic(const PhysicsObject* obj);
+	// wakes the islands that were touched and puts the islands that have been resting to sleep
+	void UpdateSleeping();
+	// moves each bullet back to where it first touched a plane or box near its path during the step
+	void SweepBullets();
+	// the furthest a box can be from its bounds in the broadphase during the step, how far it has moved this step on top of
+	// how far the contacts moved it after the broadphase was run
+	float GetBoxReach() const;
+	// adds the index of every actor that a circle of the radius moving from start to end could touch to the candidates
+	void FindCastCandidates(const glm::vec2& start, const glm::vec2& end, const float radius, std::vector<unsigned int>& candidates) const;
+	// adds the candidates to the batch and casts the circle against them, 0 radius casts a ray
+	void CastCandidates(const glm::vec2& start, const glm::vec2& end, const float radius, const std::vector<unsigned int>& candidates, RayBatch& batch) const;
+	// fills in the hit from a hit of the batch
+	RaycastHit MakeHit(const RayBatchHit& batchHit, const glm::vec2& start, const glm::vec2& end, const float radius) const;
+	// gets the nearest hit of the last cast of the batch, the nearest actor in the scene if several are hit at the same point
+	bool GetNearestHit(const RayBatch& batch, const glm::vec2& start, const glm::vec2& end, const float radius, RaycastHit& hit) const;
 
 protected:
 	// the value of gravity in this physics scene
 	glm::vec2 m_gravity;
 	// used to customise prioitisation of accuracy and speed
 	float m_timeStep;
+	// the time that has passed which hasn't been simulated yet
+	float m_accumulatedTime;
+	// the most fixed steps run by each call to Update
+	unsigned int m_maxSubSteps;
+	// the heap allocations made during the last call to Update, the contact points come from each thread's StepArena instead
+	unsigned long long m_stepAllocations;
 	// contains all the actors in the scene
 	std::vector<PhysicsObject*> m_actors;
+	// where the actor of each handle is, the slots are reused so a scene that adds and removes actors doesn't keep growing
+	std::vector<ActorSlot> m_slots;
+	// the first slot that isn't being used
+	unsigned int m_freeSlot;
+	// set while the fixed steps are running, the actors can't be moved around then
+	bool m_stepping;
+	// the actors removed during the step
+	std::vector<PhysicsObject*> m_pendingRemovals;
+	// the algorithm used to find which actors might be colliding
+	BroadphaseType m_broadphaseType;
+	// null when using brute force
+	Broadphase* m_broadphase;
+	// the pairs of actors found by the broadphase this step
+	std::vector<CollisionPair> m_pairs;
+	// null when each rigidbody stores and integrates its own state
+	BodyStore* m_bodyStore;
+	// null when the step is run on a single thread
+	WorkerPool* m_workers;
+	// the contacts found by each thread
+	std::vector<std::vector<Contact>> m_threadContacts;
+	// the contacts in the order of the pairs, from every thread or kept for the solver
+	std::vector<Contact> m_contacts;
+	// how the contacts are resolved
+	SolverType m_solverType;
+	ContactSolver m_contactSolver;
+	// the pairs that each thread found a contact for
+	std::vector<std::vector<CollisionPair>> m_threadPairs;
+	// where GJK starts searching for each pair
+	GJKCache m_gjkCache;
+	// the directions GJK finished with on each thread, stored in the cache once every pair has been checked
+	std::vector<std::vector<PairAxis>> m_threadAxes;
+	// the pairs of circles from the broadphase on each thread, filtered before any contacts are found
+	std::vector<SphereBatch> m_sphereBatches;
+	// the shapes and candidates of the queries on each thread
+	std::vector<RayBatch> m_rayBatches;
+	std::vector<std::vector<unsigned int>> m_queryCandidates;
+	// the amount of actors when the broadphase was last run, 0 if it hasn't been run or an actor has been removed since
+	unsigned int m_broadphaseCount;
+	// where each actor was when the broadphase was last run
+	std::vector<glm::vec2> m_broadphasePositions;
+	// the furthest any actor was moved by the contacts after the broadphase was run, the queries are grown by this
+	float m_querySlack;
+	// contacts are found between shapes that could touch in the next step
+	bool m_speculative;
+	float m_speculativeMargin;
+	// the events written for the touching pairs during the steps
+	ContactEventStream m_contactEvents;
+	// the pairs of actors that collided this step
+	std::vector<CollisionPair> m_collidingPairs;
+	// allows rigidbodies to fall asleep
+	bool m_sleeping;
+	// the islands of actors being built, indexed by actor
+	UnionFind m_islands;
+	// set if every rigidbody in the island has rested for long enough to sleep
+	std::vector<unsigned char> m_islandReady;
+	// the sleep island given to the rigidbodies in each island that falls asleep this step
+	std::vector<int> m_islandIds;
+	// the islands that need to be woken this step
+	std::vector<int> m_wokenIslands;
+	// the next sleep island to give out
+	int m_nextIsland;
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "Plane.h"
 #include <iostream>
+#include <limits>
 
 Plane::Plane(const glm::vec2 & normal, const float distance, const glm::vec4& colour, const bool kinematic, const float s, const float k) :
 	PhysicsObject(PLANE, colour, kinematic, s, k)
@@ -26,7 +27,7 @@ void Plane::Debug()
 	std::cout << "Kinetic Friction: " << m_k << std::endl;
 }
 
-void Plane::MakeGizmo()
+void Plane::MakeGizmo(const float /*alpha*/)
 {
 	// length of the line
 	float lineSegmentLength = 300.0f;
@@ -39,4 +40,12 @@ void Plane::MakeGizmo()
 	glm::vec2 endPos = centerPoint - (parallel * lineSegmentLength);
 	// draws the line between the 2 positions and of the specified colour
 	aie::Gizmos::add2DLine(startPos, endPos, m_colour);
+}
+
+Bounds Plane::GetBounds() const
+{
+	Bounds bounds;
+	bounds.min = glm::vec2(std::numeric_limits<float>::lowest());
+	bounds.max = glm::vec2(std::numeric_limits<float>::max());
+	return bounds;
 }
\ No newline at end of file
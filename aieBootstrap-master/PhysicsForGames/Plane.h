@@ -1,10 +1,14 @@
 #pragma once
 
 #include "PhysicsObject.h"
+#include "ObjectPool.h"
 
 class Plane : public PhysicsObject
 {
 public:
+	// the shape type of every object of this class, used to cast to this class without RTTI
+	static const ShapeType SHAPE_TYPE = PLANE;
+
 	Plane(const glm::vec2& normal, const float distance,
 		const glm::vec4& colour = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), const bool kinematic = false, const float s = 0.0f, const float k = 0.0f);
 	// determines the normal using an incline (in radians)
@@ -12,12 +16,18 @@ public:
 		const glm::vec4& colour = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), const bool kinematic = false, const float s = 0.0f, const float k = 0.0f);
 	~Plane();
 
+	// the memory comes from a pool so that spawning and removing planes doesn't use the heap each time
+	static void* operator new(size_t size) { return ObjectPool<Plane>::Get().Allocate(size); }
+	static void operator delete(void* memory, size_t size) { ObjectPool<Plane>::Get().Deallocate(memory, size); }
+
 	// does nothing because planes don't move
 	virtual void FixedUpdate(const glm::vec2& gravity, const float timeStep) {}
 	// prints the object values
 	virtual void Debug();
-	// draws the line
-	virtual void MakeGizmo();
+	// draws the line, planes don't move so alpha is not used
+	virtual void MakeGizmo(const float alpha);
+	// planes are infinite so the bounds cover the whole world
+	virtual Bounds GetBounds() const;
 
 	glm::vec2 GetNormal() const { return m_normal; }
 	float GetDistance() const { return m_distanceToOrigin; }
@@ -20,6 +20,8 @@ Poly::Poly(const glm::vec2& position, const std::vector<glm::vec2>& vertices, co
 		}
 	}
 	m_moment = 0.5f * mass * m_radius * m_radius;
+	CalculateNormals();
+	UpdateWorldVertices();
 }
 Poly::Poly(const glm::vec2& position, const std::vector<glm::vec2>& vertices, const float inclination, const float speed, const float mass,
 	const glm::vec4 & colour, const bool kinematic, const bool staticRigidbody,
@@ -40,6 +42,8 @@ Poly::Poly(const glm::vec2& position, const std::vector<glm::vec2>& vertices, co
 		}
 	}
 	m_moment = 0.5f * mass * m_radius * m_radius;
+	CalculateNormals();
+	UpdateWorldVertices();
 }
 Poly::Poly(const std::vector<glm::vec2>& vertices, const glm::vec2 & velocity, const float mass,
 	const glm::vec4 & colour, const bool kinematic, const bool staticRigidbody,
@@ -70,6 +74,8 @@ Poly::Poly(const std::vector<glm::vec2>& vertices, const glm::vec2 & velocity, c
 		}
 	}
 	m_moment = 0.5f * mass * m_radius * m_radius;
+	CalculateNormals();
+	UpdateWorldVertices();
 }
 Poly::Poly(const std::vector<glm::vec2>& vertices, const float inclination, const float speed, const float mass,
 	const glm::vec4 & colour, const bool kinematic, const bool staticRigidbody,
@@ -100,13 +106,16 @@ Poly::Poly(const std::vector<glm::vec2>& vertices, const float inclination, cons
 		}
 	}
 	m_moment = 0.5f * mass * m_radius * m_radius;
+	CalculateNormals();
+	UpdateWorldVertices();
 }
 Poly::~Poly()
 {
 }
 
-void Poly::MakeGizmo()
+void Poly::MakeGizmo(const float alpha)
 {
+	glm::vec2 position = GetInterpolatedPosition(alpha);
 	/*unfilled poly*/
 	for (int i = 0; i < m_vertices.size(); i++)
 	{
@@ -116,7 +125,7 @@ void Poly::MakeGizmo()
 			j = i + 1;
 		}
 		// draws a line between the vertices
-		aie::Gizmos::add2DLine(m_vertices[i] + m_position, m_vertices[j] + m_position, m_colour);
+		aie::Gizmos::add2DLine(m_vertices[i] + position, m_vertices[j] + position, m_colour);
 	}
 
 	/*filled poly*/
@@ -134,16 +143,50 @@ void Poly::MakeGizmo()
 	//}
 }
 
+Bounds Poly::GetBounds() const
+{
+	Bounds bounds;
+	bounds.min = m_vertices[0];
+	bounds.max = m_vertices[0];
+	// expands the box to fit each vertex
+	for (int i = 1; i < m_vertices.size(); i++)
+	{
+		bounds.min = glm::min(bounds.min, m_vertices[i]);
+		bounds.max = glm::max(bounds.max, m_vertices[i]);
+	}
+	// the vertices are relative to the position of the poly
+	bounds.min += GetPosition();
+	bounds.max += GetPosition();
+	return bounds;
+}
+glm::vec2 Poly::Support(const glm::vec2 & direction) const
+{
+	const std::vector<glm::vec2>& vertices = GetWorldVertices();
+	unsigned int best = 0;
+	float max = glm::dot(direction, vertices[0]);
+	for (unsigned int i = 1; i < vertices.size(); i++)
+	{
+		float projection = glm::dot(direction, vertices[i]);
+		if (projection > max)
+		{
+			max = projection;
+			best = i;
+		}
+	}
+	return vertices[best];
+}
+
 // returns the min and max projection of vertices on the axis
 glm::vec2 Poly::Project(const glm::vec2 & axis) const
 {
+	const std::vector<glm::vec2>& vertices = GetWorldVertices();
 	// projects the first vertex onto the axis
-	float min = glm::dot(axis, m_vertices[0] + m_position);
+	float min = glm::dot(axis, vertices[0]);
 	float max = min;
 	// iterates through each vertex storing the projection if it is less than or greater than the current min or max
-	for (int i = 1; i < m_vertices.size(); i++)
+	for (int i = 1; i < vertices.size(); i++)
 	{
-		float proj = glm::dot(axis, m_vertices[i] + m_position);
+		float proj = glm::dot(axis, vertices[i]);
 		if (proj < min)
 		{
 			min = proj;
@@ -180,10 +223,10 @@ bool Poly::Overlap(const glm::vec2 & proj1, const glm::vec2 & proj2) const
 	return true;
 }
 
-std::vector<glm::vec2> Poly::ContactPoints(const Poly * other, const glm::vec2 & normal) const
+ScratchArray<glm::vec2> Poly::ContactPoints(const Poly * other, const glm::vec2 & normal) const
 {
-	// the contact manifold
-	std::vector<glm::vec2> clippedPoints;
+	// the contact manifold, clipping never leaves more than 2 points
+	ScratchArray<glm::vec2> clippedPoints = StepArena::GetThreadArena().Allocate<glm::vec2>(2);
 
 	// gets the most relevant edges from the two polys
 	Edge edge1 = this->BestEdge(normal);
@@ -213,25 +256,30 @@ std::vector<glm::vec2> Poly::ContactPoints(const Poly * other, const glm::vec2 &
 	// the offset of the reference edge's first vertex along the reference edge
 	float offset1 = glm::dot(refEdge, ref.vert1);
 	// clips the incident edge by the first vertex in the reference edge
-	Clip(clippedPoints, inc.vert1, inc.vert2, refEdge, offset1);
+	clippedPoints.count = Clip(clippedPoints.data, inc.vert1, inc.vert2, refEdge, offset1);
 	// ensures that two points were returned
 	if (clippedPoints.size() < 2)
 	{
-		return std::vector<glm::vec2>();
+		clippedPoints.count = 0;
+		return clippedPoints;
 	}
 
 	// the offset of the reference edge's second vertex alon gthe reference edge
 	float offset2 = glm::dot(refEdge, ref.vert2);
 	// clips what is left of the incident edge by the second vertex in the reference edge
 	// the clipping will be done in the opposite direction
-	Clip(clippedPoints, clippedPoints[0], clippedPoints[1], -refEdge, -offset2);
+	// the points are copied first because the clipped points are written over them
+	glm::vec2 point1 = clippedPoints[0];
+	glm::vec2 point2 = clippedPoints[1];
+	clippedPoints.count = Clip(clippedPoints.data, point1, point2, -refEdge, -offset2);
 	if (clippedPoints.size() < 2)
 	{
-		return std::vector<glm::vec2>();
+		clippedPoints.count = 0;
+		return clippedPoints;
 	}
 
 	// get the reference edge normal
-	glm::vec2 refNorm = Cross(ref.edge, -1.0f);
+	glm::vec2 refNorm = Cross(ref.edge, 1.0f);
 	// if the incident and reference edges had to be flipped then the reference edge needs to be flipped
 	if (flip)
 	{
@@ -240,28 +288,30 @@ std::vector<glm::vec2> Poly::ContactPoints(const Poly * other, const glm::vec2 &
 	// get the largest depth
 	float max = glm::dot(refNorm, ref.max);
 	// make sure that the final points are not past this maximum
-	if (glm::dot(refNorm, clippedPoints[0]) - max < 0.0f)
+	unsigned int count = 0;
+	for (unsigned int i = 0; i < clippedPoints.size(); i++)
 	{
-		clippedPoints.erase(clippedPoints.begin());
-	}
-	if (glm::dot(refNorm, clippedPoints[1]) - max < 0.0f)
-	{
-		clippedPoints.erase(clippedPoints.begin() + 1);
+		if (glm::dot(refNorm, clippedPoints[i]) - max >= 0.0f)
+		{
+			clippedPoints[count++] = clippedPoints[i];
+		}
 	}
+	clippedPoints.count = count;
 
 	return clippedPoints;
 }
 
 Edge Poly::BestEdge(const glm::vec2 & normal) const
 {
+	const std::vector<glm::vec2>& vertices = GetWorldVertices();
 	// sets the initial maximum number as the lowest possible float value
 	float max = std::numeric_limits<float>::lowest();
 	unsigned int index = 0;
 	// finds the vertex furthest along the collision normal
-	for (int i = 0; i < m_vertices.size(); i++)
+	for (int i = 0; i < vertices.size(); i++)
 	{
 		// projects the vertex onto the normal
-		float projection = glm::dot(normal, m_vertices[i] + m_position);
+		float projection = glm::dot(normal, vertices[i]);
 		// checks if it is greater than the current maximum projection
 		if (projection > max)
 		{
@@ -273,11 +323,11 @@ Edge Poly::BestEdge(const glm::vec2 & normal) const
 	}
 
 	// gets the max vertex
-	glm::vec2 vert = m_vertices[index] + m_position;
+	glm::vec2 vert = vertices[index];
 	// gets the vertex to the right of the max
-	glm::vec2 vertNext = m_vertices[(index + 1 == m_vertices.size()) ? 0 : index + 1] + m_position;
+	glm::vec2 vertNext = vertices[(index + 1 == vertices.size()) ? 0 : index + 1];
 	// gets the vertex to the left of the max
-	glm::vec2 vertPrev = m_vertices[(index - 1 < 0) ? m_vertices.size() : index - 1] + m_position;
+	glm::vec2 vertPrev = vertices[(index == 0) ? vertices.size() - 1 : index - 1];
 
 	// gets the vector between the max vertex and left vertex to get the left edge
 	glm::vec2 leftEdge = vert - vertPrev;
@@ -310,19 +360,20 @@ Edge Poly::BestEdge(const glm::vec2 & normal) const
 }
 
 // clips the line segment between vert1 and vert2 if they are past the offset along the normal
-void Poly::Clip(std::vector<glm::vec2> clippedPoints, const glm::vec2 & vert1, const glm::vec2 & vert2, const glm::vec2 & normal, const float offset) const
+unsigned int Poly::Clip(glm::vec2* clippedPoints, const glm::vec2 & vert1, const glm::vec2 & vert2, const glm::vec2 & normal, const float offset) const
 {
+	unsigned int count = 0;
 	// checks if the points are past the offset along the normal
 	float dot1 = glm::dot(normal, vert1) - offset;
 	float dot2 = glm::dot(normal, vert2) - offset;
 	// if so then add them to the collection
 	if (dot1 >= 0.0f)
 	{
-		clippedPoints.push_back(vert1);
+		clippedPoints[count++] = vert1;
 	}
 	if (dot2 >= 0.0f)
 	{
-		clippedPoints.push_back(vert2);
+		clippedPoints[count++] = vert2;
 	}
 
 	// checks if they are on opposing sides so that the correct point is computed
@@ -335,8 +386,10 @@ void Poly::Clip(std::vector<glm::vec2> clippedPoints, const glm::vec2 & vert1, c
 		edge *= location;
 		edge += vert1;
 		// add the point
-		clippedPoints.push_back(edge);
+		clippedPoints[count++] = edge;
 	}
+
+	return count;
 }
 
 glm::vec2 Poly::Cross(const glm::vec2 & vect, const float scalar) const
@@ -345,28 +398,39 @@ glm::vec2 Poly::Cross(const glm::vec2 & vect, const float scalar) const
 	return glm::vec2(-vect.y * scalar, vect.x * scalar);
 }
 
-std::vector<glm::vec2> Poly::GetAxis() const
+const std::vector<glm::vec2>& Poly::GetWorldVertices() const
+{
+	UpdateWorldVertices();
+	return m_worldVertices;
+}
+void Poly::UpdateWorldVertices() const
+{
+	glm::vec2 position = GetPosition();
+	// the vertices are empty until the first time they are moved
+	if (m_worldVertices.size() == m_vertices.size() && position == m_worldPosition)
+	{
+		return;
+	}
+
+	m_worldVertices.resize(m_vertices.size());
+	for (int i = 0; i < m_vertices.size(); i++)
+	{
+		m_worldVertices[i] = m_vertices[i] + position;
+	}
+	m_worldPosition = position;
+}
+
+void Poly::CalculateNormals()
 {
-	// collection of vectors between vertices
-	std::vector<glm::vec2> axis;
+	m_normals.resize(m_vertices.size());
 	for (int i = 0; i < m_vertices.size(); i++)
 	{
-		glm::vec2 vert1 = m_vertices[i] + m_position;
-		glm::vec2 vert2;
 		// checks if it is at the end of the container and should wrap around to the start
-		if (i + 1 == m_vertices.size())
-		{
-			vert2 = m_vertices[0] + m_position;
-		}
-		else
-		{
-			vert2 = m_vertices[i + 1];
-		}
+		glm::vec2 vert1 = m_vertices[i];
+		glm::vec2 vert2 = m_vertices[(i + 1 == m_vertices.size()) ? 0 : i + 1];
 		// gets the vector betweem the vertices
 		glm::vec2 edge = vert2 - vert1;
 		// adds the potential collision normal to the collection
-		axis.push_back(glm::normalize(glm::vec2(-edge.y, edge.x)));
+		m_normals[i] = glm::normalize(glm::vec2(-edge.y, edge.x));
 	}
-
-	return axis;
 }
\ No newline at end of file
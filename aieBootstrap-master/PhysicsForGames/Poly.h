@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Rigidbody.h"
+#include "ObjectPool.h"
+#include "StepArena.h"
 #include <vector>
 
 // vector between two vertices
@@ -17,6 +19,9 @@ struct Edge
 class Poly : public Rigidbody
 {
 public:
+	// the shape type of every object of this class, used to cast to this class without RTTI
+	static const ShapeType SHAPE_TYPE = POLY;
+
 	// takes in a position and a collection of vertices around the position (i.e. the verts will be around the origin)
 	Poly(const glm::vec2& position, const std::vector<glm::vec2>& vertices, const glm::vec2& velocity, /*const float rotation, const float angularVelocity,*/ const float mass,
 		const glm::vec4& colour = glm::vec4(1, 1, 1, 1), const bool kinematic = false, const bool staticRigidbody = false,
@@ -35,33 +40,54 @@ public:
 		const float elasticity = 1.0f, const float linearDrag = 0.0f, const float angularDrag = 0.0f, const float s = 0.0f, const float k = 0.0f);
 	~Poly();
 
+	// the memory comes from a pool so that spawning and removing polys doesn't use the heap each time
+	static void* operator new(size_t size) { return ObjectPool<Poly>::Get().Allocate(size); }
+	static void operator delete(void* memory, size_t size) { ObjectPool<Poly>::Get().Deallocate(memory, size); }
+
 	// draws lines between each of the vertices
-	virtual void MakeGizmo();
+	virtual void MakeGizmo(const float alpha);
+	// gets the box around all of the vertices
+	virtual Bounds GetBounds() const;
+	// gets the vertex furthest along the direction
+	virtual glm::vec2 Support(const glm::vec2& direction) const;
 	// projects all vertices onto an axis and returns the smallest and largest projection
 	glm::vec2 Project(const glm::vec2& axis) const;
 	// gets the overlap amount between two projections
 	float GetOverlap(const glm::vec2& proj1, const glm::vec2& proj2) const;
 	// determines if there is an overlap between two projections
 	bool Overlap(const glm::vec2& proj1, const glm::vec2& proj2) const;
-	// gets a collection of points where two polys collide
-	std::vector<glm::vec2> ContactPoints(const Poly* other, const glm::vec2& normal) const;
+	// gets a collection of points where two polys collide, only valid until the end of the step
+	ScratchArray<glm::vec2> ContactPoints(const Poly* other, const glm::vec2& normal) const;
 
 	// gets all potential collision normals of the poly
-	std::vector<glm::vec2> GetAxis() const;
-	std::vector<glm::vec2> GetVertices() const { return m_vertices; }
+	// polys don't rotate, so the normals are the same wherever the poly is and are only worked out when it is created
+	const std::vector<glm::vec2>& GetAxis() const { return m_normals; }
+	const std::vector<glm::vec2>& GetVertices() const { return m_vertices; }
+	// gets the vertices in world space, they are only moved again once the position has changed
+	const std::vector<glm::vec2>& GetWorldVertices() const;
+	// moves the world space vertices to the current position if the poly has moved
+	// the scene calls this before checking pairs on several threads, so the threads only read the vertices
+	void UpdateWorldVertices() const;
 	float GetRadius() const { return m_radius; }
 
 protected:
 	// determines which edge of the poly is best for checking for collision points
 	Edge BestEdge(const glm::vec2& normal) const;
-	// clips the edge based on an offset along the normal
-	void Clip(std::vector<glm::vec2> clippedPoints, const glm::vec2& vert1, const glm::vec2& vert2, const glm::vec2& normal, const float offset) const;
+	// clips the edge based on an offset along the normal, writes up to 2 points and returns how many were written
+	unsigned int Clip(glm::vec2* clippedPoints, const glm::vec2& vert1, const glm::vec2& vert2, const glm::vec2& normal, const float offset) const;
 	// cross product
 	glm::vec2 Cross(const glm::vec2& vect, const float scalar) const;
+	// works out the normal of each edge, called once the vertices are set
+	void CalculateNormals();
 
 protected:
 	// the vertex furthest from the position of the poly
 	float m_radius;
 	// collection of vectors of vertices from the position of the poly
 	std::vector<glm::vec2> m_vertices;
+	// the normal of the edge from each vertex to the next one
+	std::vector<glm::vec2> m_normals;
+	// the vertices added to the position they were last moved to
+	mutable std::vector<glm::vec2> m_worldVertices;
+	mutable glm::vec2 m_worldPosition;
 };
\ No newline at end of file
@@ -0,0 +1,553 @@
+#include "RayBatch.h"
+#include <algorithm>
+#include <cfloat>
+
+// the fraction given to the side of an edge or box that doesn't limit the cast
+#define RAY_UNBOUNDED FLT_MAX
+
+// checks if the point is inside the poly or within the distance of one of its edges
+static bool NearPoly(const glm::vec2& point, const float distance, const float* vertexX, const float* vertexY,
+	const float* normalX, const float* normalY, const float* edgeDistance, const unsigned int count)
+{
+	bool inside = true;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		if (normalX[i] * point.x + normalY[i] * point.y > edgeDistance[i])
+		{
+			inside = false;
+			break;
+		}
+	}
+	if (inside)
+	{
+		return true;
+	}
+
+	// outside a convex poly the closest point is on one of the edges
+	for (unsigned int i = 0; i < count; i++)
+	{
+		glm::vec2 vert1 = glm::vec2(vertexX[i], vertexY[i]);
+		glm::vec2 vert2 = (i + 1 == count) ? glm::vec2(vertexX[0], vertexY[0]) : glm::vec2(vertexX[i + 1], vertexY[i + 1]);
+		glm::vec2 edge = vert2 - vert1;
+		float lengthSquared = glm::dot(edge, edge);
+		float t = (lengthSquared > 0.0f) ? glm::clamp(glm::dot(point - vert1, edge) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+		glm::vec2 offset = point - (vert1 + edge * t);
+		if (glm::dot(offset, offset) <= distance * distance)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+RayBatch::RayBatch()
+{
+	m_radius = 0.0f;
+	m_simdLevel = ::GetSimdLevel();
+}
+RayBatch::~RayBatch()
+{
+}
+
+void RayBatch::Clear()
+{
+	// clearing keeps the capacity, so the arrays stop allocating once they have grown to the size of the largest batch
+	m_circleShapes.clear();
+	m_circleX.clear();
+	m_circleY.clear();
+	m_circleRadius.clear();
+	m_boxShapes.clear();
+	m_boxMinX.clear();
+	m_boxMinY.clear();
+	m_boxMaxX.clear();
+	m_boxMaxY.clear();
+	m_polyShapes.clear();
+	m_polyBegin.clear();
+	m_edgeNormalX.clear();
+	m_edgeNormalY.clear();
+	m_edgeDistance.clear();
+	m_edgeVertexX.clear();
+	m_edgeVertexY.clear();
+	m_planeShapes.clear();
+	m_planeNormals.clear();
+	m_planeDistances.clear();
+	m_hits.clear();
+}
+void RayBatch::AddCircle(const unsigned int shape, const glm::vec2 & centre, const float radius)
+{
+	m_circleShapes.push_back(shape);
+	m_circleX.push_back(centre.x);
+	m_circleY.push_back(centre.y);
+	m_circleRadius.push_back(radius);
+}
+void RayBatch::AddBox(const unsigned int shape, const glm::vec2 & min, const glm::vec2 & max)
+{
+	m_boxShapes.push_back(shape);
+	m_boxMinX.push_back(min.x);
+	m_boxMinY.push_back(min.y);
+	m_boxMaxX.push_back(max.x);
+	m_boxMaxY.push_back(max.y);
+}
+void RayBatch::AddPoly(const unsigned int shape, const std::vector<glm::vec2>& vertices, const std::vector<glm::vec2>& normals)
+{
+	if (vertices.empty())
+	{
+		return;
+	}
+
+	// the normals of a poly point into it when its vertices go anticlockwise, so they are flipped if they face the centre
+	glm::vec2 centre = glm::vec2(0.0f, 0.0f);
+	for (const glm::vec2& vertex : vertices)
+	{
+		centre += vertex;
+	}
+	centre /= (float)vertices.size();
+	float direction = (glm::dot(normals[0], vertices[0] - centre) < 0.0f) ? -1.0f : 1.0f;
+
+	m_polyShapes.push_back(shape);
+	m_polyBegin.push_back(m_edgeNormalX.size());
+	for (unsigned int i = 0; i < vertices.size(); i++)
+	{
+		glm::vec2 normal = normals[i] * direction;
+		m_edgeNormalX.push_back(normal.x);
+		m_edgeNormalY.push_back(normal.y);
+		m_edgeDistance.push_back(glm::dot(normal, vertices[i]));
+		m_edgeVertexX.push_back(vertices[i].x);
+		m_edgeVertexY.push_back(vertices[i].y);
+	}
+}
+void RayBatch::AddPlane(const unsigned int shape, const glm::vec2 & normal, const float distance)
+{
+	m_planeShapes.push_back(shape);
+	m_planeNormals.push_back(normal);
+	m_planeDistances.push_back(distance);
+}
+
+void RayBatch::Cast(const glm::vec2 & start, const glm::vec2 & displacement, const float radius)
+{
+	m_hits.clear();
+	m_segment = SweepSegment(start, displacement);
+	m_radius = radius;
+	// a cast that doesn't move can only reach the shapes it is already touching
+	if (m_segment.lengthSquared == 0.0f)
+	{
+		return;
+	}
+
+	// the simd paths leave the shapes that don't fill a whole register for the scalar loops
+	unsigned int circleCount = m_circleShapes.size();
+	unsigned int boxCount = m_boxShapes.size();
+	unsigned int edgeCount = m_edgeNormalX.size();
+	if (m_edgeEnter.size() < edgeCount)
+	{
+		m_edgeEnter.resize(edgeCount);
+		m_edgeExit.resize(edgeCount);
+	}
+	unsigned int circles = 0;
+	unsigned int boxes = 0;
+	unsigned int edges = 0;
+	if (m_simdLevel == SIMD_AVX2)
+	{
+		circles = CastCirclesAVX2(0, circleCount);
+		boxes = CastBoxesAVX2(0, boxCount);
+		edges = ClipEdgesAVX2(0, edgeCount);
+	}
+	else if (m_simdLevel == SIMD_SSE2)
+	{
+		circles = CastCirclesSSE2(0, circleCount);
+		boxes = CastBoxesSSE2(0, boxCount);
+		edges = ClipEdgesSSE2(0, edgeCount);
+	}
+	CastCirclesScalar(circles, circleCount);
+	CastBoxesScalar(boxes, boxCount);
+	ClipEdgesScalar(edges, edgeCount);
+	AddPolyHits();
+	CastPlanes();
+}
+void RayBatch::SortHits()
+{
+	std::sort(m_hits.begin(), m_hits.end(), [](const RayBatchHit& hit1, const RayBatchHit& hit2)
+	{
+		return (hit1.fraction != hit2.fraction) ? hit1.fraction < hit2.fraction : hit1.shape < hit2.shape;
+	});
+}
+
+void RayBatch::SetSimdLevel(const SimdLevel simdLevel)
+{
+	SimdLevel supported = ::GetSimdLevel();
+	m_simdLevel = (simdLevel > supported) ? supported : simdLevel;
+}
+
+void RayBatch::CastCirclesScalar(const unsigned int begin, const unsigned int end)
+{
+	for (unsigned int i = begin; i < end; i++)
+	{
+		AddCircleHit(i);
+	}
+}
+
+// the simd paths do the same checks as SweepCircle on 4 or 8 circles at once and then add the circles that are hit
+unsigned int RayBatch::CastCirclesSSE2(const unsigned int begin, const unsigned int end)
+{
+#if SIMD_X86
+	const __m128 startX = _mm_set1_ps(m_segment.start.x);
+	const __m128 startY = _mm_set1_ps(m_segment.start.y);
+	const __m128 displacementX = _mm_set1_ps(m_segment.displacement.x);
+	const __m128 displacementY = _mm_set1_ps(m_segment.displacement.y);
+	const __m128 radius = _mm_set1_ps(m_radius);
+	const __m128 a = _mm_set1_ps(m_segment.lengthSquared);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	unsigned int stop = begin + ((end - begin) & ~3u);
+	for (unsigned int i = begin; i < stop; i += 4)
+	{
+		__m128 offsetX = _mm_sub_ps(startX, _mm_loadu_ps(&m_circleX[i]));
+		__m128 offsetY = _mm_sub_ps(startY, _mm_loadu_ps(&m_circleY[i]));
+		__m128 radii = _mm_add_ps(_mm_loadu_ps(&m_circleRadius[i]), radius);
+		__m128 b = _mm_add_ps(_mm_mul_ps(offsetX, displacementX), _mm_mul_ps(offsetY, displacementY));
+		__m128 c = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(offsetX, offsetX), _mm_mul_ps(offsetY, offsetY)), _mm_mul_ps(radii, radii));
+		__m128 closest = _mm_div_ps(_mm_sub_ps(zero, b), a);
+		__m128 closestX = _mm_add_ps(offsetX, _mm_mul_ps(displacementX, closest));
+		__m128 closestY = _mm_add_ps(offsetY, _mm_mul_ps(displacementY, closest));
+		__m128 h = _mm_sub_ps(_mm_mul_ps(radii, radii), _mm_add_ps(_mm_mul_ps(closestX, closestX), _mm_mul_ps(closestY, closestY)));
+		// the lanes that miss take the square root of a negative number, which fails the last check
+		__m128 t = _mm_sub_ps(closest, _mm_sqrt_ps(_mm_div_ps(h, a)));
+		__m128 hit = _mm_and_ps(_mm_and_ps(_mm_cmpgt_ps(c, zero), _mm_cmplt_ps(b, zero)),
+			_mm_and_ps(_mm_cmpge_ps(h, zero), _mm_cmple_ps(t, one)));
+		int hits = _mm_movemask_ps(hit);
+
+		for (unsigned int j = 0; j < 4; j++)
+		{
+			if ((hits >> j) & 1)
+			{
+				AddCircleHit(i + j);
+			}
+		}
+	}
+	return stop;
+#else
+	return begin;
+#endif
+}
+SIMD_AVX2_FUNCTION unsigned int RayBatch::CastCirclesAVX2(const unsigned int begin, const unsigned int end)
+{
+#if SIMD_X86
+	const __m256 startX = _mm256_set1_ps(m_segment.start.x);
+	const __m256 startY = _mm256_set1_ps(m_segment.start.y);
+	const __m256 displacementX = _mm256_set1_ps(m_segment.displacement.x);
+	const __m256 displacementY = _mm256_set1_ps(m_segment.displacement.y);
+	const __m256 radius = _mm256_set1_ps(m_radius);
+	const __m256 a = _mm256_set1_ps(m_segment.lengthSquared);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+
+	unsigned int stop = begin + ((end - begin) & ~7u);
+	for (unsigned int i = begin; i < stop; i += 8)
+	{
+		__m256 offsetX = _mm256_sub_ps(startX, _mm256_loadu_ps(&m_circleX[i]));
+		__m256 offsetY = _mm256_sub_ps(startY, _mm256_loadu_ps(&m_circleY[i]));
+		__m256 radii = _mm256_add_ps(_mm256_loadu_ps(&m_circleRadius[i]), radius);
+		__m256 b = _mm256_add_ps(_mm256_mul_ps(offsetX, displacementX), _mm256_mul_ps(offsetY, displacementY));
+		__m256 c = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(offsetX, offsetX), _mm256_mul_ps(offsetY, offsetY)), _mm256_mul_ps(radii, radii));
+		__m256 closest = _mm256_div_ps(_mm256_sub_ps(zero, b), a);
+		__m256 closestX = _mm256_add_ps(offsetX, _mm256_mul_ps(displacementX, closest));
+		__m256 closestY = _mm256_add_ps(offsetY, _mm256_mul_ps(displacementY, closest));
+		__m256 h = _mm256_sub_ps(_mm256_mul_ps(radii, radii), _mm256_add_ps(_mm256_mul_ps(closestX, closestX), _mm256_mul_ps(closestY, closestY)));
+		__m256 t = _mm256_sub_ps(closest, _mm256_sqrt_ps(_mm256_div_ps(h, a)));
+		__m256 hit = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(c, zero, _CMP_GT_OQ), _mm256_cmp_ps(b, zero, _CMP_LT_OQ)),
+			_mm256_and_ps(_mm256_cmp_ps(h, zero, _CMP_GE_OQ), _mm256_cmp_ps(t, one, _CMP_LE_OQ)));
+		int hits = _mm256_movemask_ps(hit);
+
+		for (unsigned int j = 0; j < 8; j++)
+		{
+			if ((hits >> j) & 1)
+			{
+				AddCircleHit(i + j);
+			}
+		}
+	}
+	return stop;
+#else
+	return begin;
+#endif
+}
+
+void RayBatch::CastBoxesScalar(const unsigned int begin, const unsigned int end)
+{
+	for (unsigned int i = begin; i < end; i++)
+	{
+		AddBoxHit(i);
+	}
+}
+
+// the simd paths do the slab test on 4 or 8 boxes grown by the radius, the boxes that pass are checked by SweepBox
+// which tells the sides apart from the corners
+unsigned int RayBatch::CastBoxesSSE2(const unsigned int begin, const unsigned int end)
+{
+#if SIMD_X86
+	const __m128 startX = _mm_set1_ps(m_segment.start.x);
+	const __m128 startY = _mm_set1_ps(m_segment.start.y);
+	const __m128 inverseX = _mm_set1_ps(m_segment.inverse.x);
+	const __m128 inverseY = _mm_set1_ps(m_segment.inverse.y);
+	const __m128 radius = _mm_set1_ps(m_radius);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	// a circle can start inside the grown box and still reach one of the corners, a ray has to start outside the box
+	const __m128 minimumEnter = _mm_set1_ps(m_radius > 0.0f ? -RAY_UNBOUNDED : 0.0f);
+
+	unsigned int stop = begin + ((end - begin) & ~3u);
+	for (unsigned int i = begin; i < stop; i += 4)
+	{
+		__m128 nearX = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(_mm_loadu_ps(&m_boxMinX[i]), radius), startX), inverseX);
+		__m128 farX = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_loadu_ps(&m_boxMaxX[i]), radius), startX), inverseX);
+		__m128 nearY = _mm_mul_ps(_mm_sub_ps(_mm_sub_ps(_mm_loadu_ps(&m_boxMinY[i]), radius), startY), inverseY);
+		__m128 farY = _mm_mul_ps(_mm_sub_ps(_mm_add_ps(_mm_loadu_ps(&m_boxMaxY[i]), radius), startY), inverseY);
+		__m128 enter = _mm_max_ps(_mm_min_ps(nearX, farX), _mm_min_ps(nearY, farY));
+		__m128 exit = _mm_min_ps(_mm_max_ps(nearX, farX), _mm_max_ps(nearY, farY));
+		__m128 hit = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(enter, exit), _mm_cmple_ps(enter, one)),
+			_mm_and_ps(_mm_cmpgt_ps(exit, zero), _mm_cmpgt_ps(enter, minimumEnter)));
+		int hits = _mm_movemask_ps(hit);
+
+		for (unsigned int j = 0; j < 4; j++)
+		{
+			if ((hits >> j) & 1)
+			{
+				AddBoxHit(i + j);
+			}
+		}
+	}
+	return stop;
+#else
+	return begin;
+#endif
+}
+SIMD_AVX2_FUNCTION unsigned int RayBatch::CastBoxesAVX2(const unsigned int begin, const unsigned int end)
+{
+#if SIMD_X86
+	const __m256 startX = _mm256_set1_ps(m_segment.start.x);
+	const __m256 startY = _mm256_set1_ps(m_segment.start.y);
+	const __m256 inverseX = _mm256_set1_ps(m_segment.inverse.x);
+	const __m256 inverseY = _mm256_set1_ps(m_segment.inverse.y);
+	const __m256 radius = _mm256_set1_ps(m_radius);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 minimumEnter = _mm256_set1_ps(m_radius > 0.0f ? -RAY_UNBOUNDED : 0.0f);
+
+	unsigned int stop = begin + ((end - begin) & ~7u);
+	for (unsigned int i = begin; i < stop; i += 8)
+	{
+		__m256 nearX = _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(_mm256_loadu_ps(&m_boxMinX[i]), radius), startX), inverseX);
+		__m256 farX = _mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(_mm256_loadu_ps(&m_boxMaxX[i]), radius), startX), inverseX);
+		__m256 nearY = _mm256_mul_ps(_mm256_sub_ps(_mm256_sub_ps(_mm256_loadu_ps(&m_boxMinY[i]), radius), startY), inverseY);
+		__m256 farY = _mm256_mul_ps(_mm256_sub_ps(_mm256_add_ps(_mm256_loadu_ps(&m_boxMaxY[i]), radius), startY), inverseY);
+		__m256 enter = _mm256_max_ps(_mm256_min_ps(nearX, farX), _mm256_min_ps(nearY, farY));
+		__m256 exit = _mm256_min_ps(_mm256_max_ps(nearX, farX), _mm256_max_ps(nearY, farY));
+		__m256 hit = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(enter, exit, _CMP_LE_OQ), _mm256_cmp_ps(enter, one, _CMP_LE_OQ)),
+			_mm256_and_ps(_mm256_cmp_ps(exit, zero, _CMP_GT_OQ), _mm256_cmp_ps(enter, minimumEnter, _CMP_GT_OQ)));
+		int hits = _mm256_movemask_ps(hit);
+
+		for (unsigned int j = 0; j < 8; j++)
+		{
+			if ((hits >> j) & 1)
+			{
+				AddBoxHit(i + j);
+			}
+		}
+	}
+	return stop;
+#else
+	return begin;
+#endif
+}
+
+// each edge keeps the cast to the side of it that the poly is on (Cyrus-Beck clipping), an edge the cast moves towards
+// gives the fraction it enters that side and an edge it moves away from gives the fraction it leaves
+// the poly is grown by the radius by moving each edge out along its normal
+void RayBatch::ClipEdgesScalar(const unsigned int begin, const unsigned int end)
+{
+	for (unsigned int i = begin; i < end; i++)
+	{
+		float distance = (m_edgeDistance[i] + m_radius) - (m_edgeNormalX[i] * m_segment.start.x + m_edgeNormalY[i] * m_segment.start.y);
+		float speed = m_edgeNormalX[i] * m_segment.displacement.x + m_edgeNormalY[i] * m_segment.displacement.y;
+		float t = distance / speed;
+		// moving parallel to the edge, the cast is either on the side of the poly the whole way or never
+		bool outside = speed == 0.0f && distance < 0.0f;
+		m_edgeEnter[i] = (speed < 0.0f) ? t : (outside ? RAY_UNBOUNDED : -RAY_UNBOUNDED);
+		m_edgeExit[i] = (speed > 0.0f) ? t : (outside ? -RAY_UNBOUNDED : RAY_UNBOUNDED);
+	}
+}
+// the simd paths pick between the fractions with masks instead of branches
+unsigned int RayBatch::ClipEdgesSSE2(const unsigned int begin, const unsigned int end)
+{
+#if SIMD_X86
+	const __m128 startX = _mm_set1_ps(m_segment.start.x);
+	const __m128 startY = _mm_set1_ps(m_segment.start.y);
+	const __m128 displacementX = _mm_set1_ps(m_segment.displacement.x);
+	const __m128 displacementY = _mm_set1_ps(m_segment.displacement.y);
+	const __m128 radius = _mm_set1_ps(m_radius);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 unbounded = _mm_set1_ps(RAY_UNBOUNDED);
+	const __m128 unboundedBelow = _mm_set1_ps(-RAY_UNBOUNDED);
+
+	unsigned int stop = begin + ((end - begin) & ~3u);
+	for (unsigned int i = begin; i < stop; i += 4)
+	{
+		__m128 normalX = _mm_loadu_ps(&m_edgeNormalX[i]);
+		__m128 normalY = _mm_loadu_ps(&m_edgeNormalY[i]);
+		__m128 distance = _mm_sub_ps(_mm_add_ps(_mm_loadu_ps(&m_edgeDistance[i]), radius),
+			_mm_add_ps(_mm_mul_ps(normalX, startX), _mm_mul_ps(normalY, startY)));
+		__m128 speed = _mm_add_ps(_mm_mul_ps(normalX, displacementX), _mm_mul_ps(normalY, displacementY));
+		__m128 t = _mm_div_ps(distance, speed);
+		__m128 outside = _mm_and_ps(_mm_cmpeq_ps(speed, zero), _mm_cmplt_ps(distance, zero));
+		__m128 entering = _mm_cmplt_ps(speed, zero);
+		__m128 leaving = _mm_cmpgt_ps(speed, zero);
+		__m128 enterOtherwise = _mm_or_ps(_mm_and_ps(outside, unbounded), _mm_andnot_ps(outside, unboundedBelow));
+		__m128 exitOtherwise = _mm_or_ps(_mm_and_ps(outside, unboundedBelow), _mm_andnot_ps(outside, unbounded));
+		_mm_storeu_ps(&m_edgeEnter[i], _mm_or_ps(_mm_and_ps(entering, t), _mm_andnot_ps(entering, enterOtherwise)));
+		_mm_storeu_ps(&m_edgeExit[i], _mm_or_ps(_mm_and_ps(leaving, t), _mm_andnot_ps(leaving, exitOtherwise)));
+	}
+	return stop;
+#else
+	return begin;
+#endif
+}
+SIMD_AVX2_FUNCTION unsigned int RayBatch::ClipEdgesAVX2(const unsigned int begin, const unsigned int end)
+{
+#if SIMD_X86
+	const __m256 startX = _mm256_set1_ps(m_segment.start.x);
+	const __m256 startY = _mm256_set1_ps(m_segment.start.y);
+	const __m256 displacementX = _mm256_set1_ps(m_segment.displacement.x);
+	const __m256 displacementY = _mm256_set1_ps(m_segment.displacement.y);
+	const __m256 radius = _mm256_set1_ps(m_radius);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 unbounded = _mm256_set1_ps(RAY_UNBOUNDED);
+	const __m256 unboundedBelow = _mm256_set1_ps(-RAY_UNBOUNDED);
+
+	unsigned int stop = begin + ((end - begin) & ~7u);
+	for (unsigned int i = begin; i < stop; i += 8)
+	{
+		__m256 normalX = _mm256_loadu_ps(&m_edgeNormalX[i]);
+		__m256 normalY = _mm256_loadu_ps(&m_edgeNormalY[i]);
+		__m256 distance = _mm256_sub_ps(_mm256_add_ps(_mm256_loadu_ps(&m_edgeDistance[i]), radius),
+			_mm256_add_ps(_mm256_mul_ps(normalX, startX), _mm256_mul_ps(normalY, startY)));
+		__m256 speed = _mm256_add_ps(_mm256_mul_ps(normalX, displacementX), _mm256_mul_ps(normalY, displacementY));
+		__m256 t = _mm256_div_ps(distance, speed);
+		__m256 outside = _mm256_and_ps(_mm256_cmp_ps(speed, zero, _CMP_EQ_OQ), _mm256_cmp_ps(distance, zero, _CMP_LT_OQ));
+		__m256 enterOtherwise = _mm256_blendv_ps(unboundedBelow, unbounded, outside);
+		__m256 exitOtherwise = _mm256_blendv_ps(unbounded, unboundedBelow, outside);
+		_mm256_storeu_ps(&m_edgeEnter[i], _mm256_blendv_ps(enterOtherwise, t, _mm256_cmp_ps(speed, zero, _CMP_LT_OQ)));
+		_mm256_storeu_ps(&m_edgeExit[i], _mm256_blendv_ps(exitOtherwise, t, _mm256_cmp_ps(speed, zero, _CMP_GT_OQ)));
+	}
+	return stop;
+#else
+	return begin;
+#endif
+}
+
+void RayBatch::AddCircleHit(const unsigned int circle)
+{
+	float radius = m_circleRadius[circle] + m_radius;
+	float fraction;
+	if (!SweepCircle(m_segment, glm::vec2(m_circleX[circle], m_circleY[circle]), radius, fraction))
+	{
+		return;
+	}
+	glm::vec2 point = m_segment.start + m_segment.displacement * fraction;
+	glm::vec2 normal = (point - glm::vec2(m_circleX[circle], m_circleY[circle])) / radius;
+	m_hits.push_back({ m_circleShapes[circle], fraction, normal });
+}
+void RayBatch::AddBoxHit(const unsigned int box)
+{
+	float fraction;
+	glm::vec2 normal;
+	if (SweepBox(m_segment, m_radius, glm::vec2(m_boxMinX[box], m_boxMinY[box]), glm::vec2(m_boxMaxX[box], m_boxMaxY[box]), fraction, normal))
+	{
+		m_hits.push_back({ m_boxShapes[box], fraction, normal });
+	}
+}
+void RayBatch::AddPolyHits()
+{
+	unsigned int polyCount = m_polyShapes.size();
+	for (unsigned int poly = 0; poly < polyCount; poly++)
+	{
+		unsigned int begin = m_polyBegin[poly];
+		unsigned int end = (poly + 1 < polyCount) ? m_polyBegin[poly + 1] : m_edgeNormalX.size();
+
+		// the cast is inside the poly between the last edge it enters and the first edge it leaves
+		float enter = -RAY_UNBOUNDED;
+		float exit = RAY_UNBOUNDED;
+		unsigned int entering = begin;
+		for (unsigned int i = begin; i < end; i++)
+		{
+			if (m_edgeEnter[i] > enter)
+			{
+				enter = m_edgeEnter[i];
+				entering = i;
+			}
+			exit = fminf(exit, m_edgeExit[i]);
+		}
+		if (!(enter <= exit && enter <= 1.0f && exit > 0.0f))
+		{
+			continue;
+		}
+
+		if (enter > 0.0f)
+		{
+			// a circle only touches the edge it entered through if it reaches it between the edge's vertices
+			bool edgeHit = m_radius == 0.0f;
+			if (!edgeHit)
+			{
+				unsigned int next = (entering + 1 == end) ? begin : entering + 1;
+				glm::vec2 vert1 = glm::vec2(m_edgeVertexX[entering], m_edgeVertexY[entering]);
+				glm::vec2 edge = glm::vec2(m_edgeVertexX[next], m_edgeVertexY[next]) - vert1;
+				float along = glm::dot(m_segment.start + m_segment.displacement * enter - vert1, edge);
+				edgeHit = along >= 0.0f && along <= glm::dot(edge, edge);
+			}
+			if (edgeHit)
+			{
+				m_hits.push_back({ m_polyShapes[poly], enter, glm::vec2(m_edgeNormalX[entering], m_edgeNormalY[entering]) });
+				continue;
+			}
+		}
+		// a ray starting on the side of every edge is inside the poly, a circle is if it is also near the poly
+		else if (m_radius == 0.0f || NearPoly(m_segment.start, m_radius, &m_edgeVertexX[begin], &m_edgeVertexY[begin],
+			&m_edgeNormalX[begin], &m_edgeNormalY[begin], &m_edgeDistance[begin], end - begin))
+		{
+			continue;
+		}
+
+		// past a corner of the grown poly, the circle first touches the poly at one of the vertices
+		float nearest = RAY_UNBOUNDED;
+		unsigned int vertex = begin;
+		for (unsigned int i = begin; i < end; i++)
+		{
+			float fraction;
+			if (SweepCircle(m_segment, glm::vec2(m_edgeVertexX[i], m_edgeVertexY[i]), m_radius, fraction) && fraction < nearest)
+			{
+				nearest = fraction;
+				vertex = i;
+			}
+		}
+		if (nearest != RAY_UNBOUNDED)
+		{
+			glm::vec2 normal = (m_segment.start + m_segment.displacement * nearest - glm::vec2(m_edgeVertexX[vertex], m_edgeVertexY[vertex])) / m_radius;
+			m_hits.push_back({ m_polyShapes[poly], nearest, normal });
+		}
+	}
+}
+void RayBatch::CastPlanes()
+{
+	// the same as SweepPlane in the physics scene, but starting on the plane isn't a hit
+	for (unsigned int i = 0; i < m_planeShapes.size(); i++)
+	{
+		const glm::vec2& normal = m_planeNormals[i];
+		float startDistance = glm::dot(m_segment.start, normal) - m_planeDistances[i] - m_radius;
+		float endDistance = startDistance + glm::dot(m_segment.displacement, normal);
+		if (startDistance <= 0.0f || endDistance >= 0.0f)
+		{
+			continue;
+		}
+		m_hits.push_back({ m_planeShapes[i], startDistance / (startDistance - endDistance), normal });
+	}
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <vector>
+#include "PhysicsObject.h"
+#include "Simd.h"
+#include "Sweep.h"
+
+// a segment to cast from start to end
+struct Ray
+{
+	glm::vec2 start;
+	glm::vec2 end;
+};
+
+// where a ray or a circle cast first touched an actor
+struct RaycastHit
+{
+	// null if nothing was hit
+	PhysicsObject* actor;
+	// the point on the surface of the actor that was touched
+	glm::vec2 point;
+	// the normal of the surface at the point, facing back towards the start of the cast
+	glm::vec2 normal;
+	// how far along the segment the cast got before touching the actor, from 0 to 1
+	float fraction;
+};
+
+// a shape hit by the last cast of a ray batch
+struct RayBatchHit
+{
+	// the number used to refer to the shape when it was added
+	unsigned int shape;
+	float fraction;
+	glm::vec2 normal;
+};
+
+// casts a ray or a circle against a batch of shapes, the circles and boxes are checked several shapes at a time and
+// the edges of every poly are clipped against the segment several edges at a time
+// the shapes are stored as arrays of each value (structure of arrays) so the simd paths can load 4 or 8 at once
+// the simd paths only find which shapes are hit, the fraction and normal of each hit are worked out by the same scalar
+// code on every path, so the hits are the same whichever instruction set is used
+class RayBatch
+{
+public:
+	RayBatch();
+	~RayBatch();
+
+	// removes the shapes and hits from the last batch
+	void Clear();
+	// adds a shape, the shape is the number used to refer to it when it is hit
+	void AddCircle(const unsigned int shape, const glm::vec2& centre, const float radius);
+	void AddBox(const unsigned int shape, const glm::vec2& min, const glm::vec2& max);
+	// the vertices are in world space and the normals are those of the edge from each vertex to the next, in either direction
+	void AddPoly(const unsigned int shape, const std::vector<glm::vec2>& vertices, const std::vector<glm::vec2>& normals);
+	// planes are solid behind the normal
+	void AddPlane(const unsigned int shape, const glm::vec2& normal, const float distance);
+	// moves a circle of the radius from the start along the displacement and finds every shape it touches, 0 casts a ray
+	// shapes that the circle already overlaps or touches at the start are not hit, so a cast can start on a surface
+	void Cast(const glm::vec2& start, const glm::vec2& displacement, const float radius);
+	// sorts the hits from the nearest to the furthest, hits the same distance away are sorted by shape
+	void SortHits();
+
+	// limits the instruction set used by Cast, levels the cpu doesn't support are lowered to the best one it does
+	void SetSimdLevel(const SimdLevel simdLevel);
+	SimdLevel GetSimdLevel() const { return m_simdLevel; }
+
+	// the shapes hit by the last call to Cast, in the order they were found
+	unsigned int GetHitCount() const { return m_hits.size(); }
+	const RayBatchHit* GetHits() const { return m_hits.data(); }
+
+protected:
+	// check the circles, boxes or edges from begin up to but not including end against the cast
+	// the simd paths check groups of 4 or 8 and return the index they stopped at, the rest are left for the scalar loop
+	void CastCirclesScalar(const unsigned int begin, const unsigned int end);
+	unsigned int CastCirclesSSE2(const unsigned int begin, const unsigned int end);
+	unsigned int CastCirclesAVX2(const unsigned int begin, const unsigned int end);
+	void CastBoxesScalar(const unsigned int begin, const unsigned int end);
+	unsigned int CastBoxesSSE2(const unsigned int begin, const unsigned int end);
+	unsigned int CastBoxesAVX2(const unsigned int begin, const unsigned int end);
+	// writes the fractions where the segment crosses each edge into the enter and exit arrays
+	void ClipEdgesScalar(const unsigned int begin, const unsigned int end);
+	unsigned int ClipEdgesSSE2(const unsigned int begin, const unsigned int end);
+	unsigned int ClipEdgesAVX2(const unsigned int begin, const unsigned int end);
+	// adds the hits for the circle and box found by the simd paths
+	void AddCircleHit(const unsigned int circle);
+	void AddBoxHit(const unsigned int box);
+	// combines the fractions of the edges of each poly into a hit
+	void AddPolyHits();
+	void CastPlanes();
+
+protected:
+	// the circles
+	std::vector<unsigned int> m_circleShapes;
+	std::vector<float> m_circleX;
+	std::vector<float> m_circleY;
+	std::vector<float> m_circleRadius;
+	// the boxes
+	std::vector<unsigned int> m_boxShapes;
+	std::vector<float> m_boxMinX;
+	std::vector<float> m_boxMinY;
+	std::vector<float> m_boxMaxX;
+	std::vector<float> m_boxMaxY;
+	// the polys, each one uses the edges from its begin up to the begin of the next poly
+	std::vector<unsigned int> m_polyShapes;
+	std::vector<unsigned int> m_polyBegin;
+	// the edges of every poly, the normals face out of the poly and the distance is the normal dotted with the first vertex
+	std::vector<float> m_edgeNormalX;
+	std::vector<float> m_edgeNormalY;
+	std::vector<float> m_edgeDistance;
+	std::vector<float> m_edgeVertexX;
+	std::vector<float> m_edgeVertexY;
+	// the fractions of the cast where it crosses into and out of the side of each edge that the poly is on
+	std::vector<float> m_edgeEnter;
+	std::vector<float> m_edgeExit;
+	// the planes
+	std::vector<unsigned int> m_planeShapes;
+	std::vector<glm::vec2> m_planeNormals;
+	std::vector<float> m_planeDistances;
+
+	// the cast being checked
+	SweepSegment m_segment;
+	float m_radius;
+
+	// the shapes hit by the last cast
+	std::vector<RayBatchHit> m_hits;
+	// the instruction set used by Cast
+	SimdLevel m_simdLevel;
+};
\ No newline at end of file
@@ -1,9 +1,7 @@
 #include "Rigidbody.h"
+#include "BodyStore.h"
 #include <iostream>
 
-#define MIN_LINEAR_THRESHOLD 0.0001f
-#define MIN_ROTATION_THRESHOLD 0.00001f
-
 Rigidbody::Rigidbody(const ShapeType& shapeID, const glm::vec2& position, const glm::vec2& velocity, const float rotation, const float angularVelocity, const float mass,
 	const glm::vec4& colour, const bool kinematic, const bool staticRigidbody,
 	const float elasticity, const float linearDrag, const float angularDrag, const float s, const float k) :
@@ -18,14 +16,32 @@ Rigidbody::Rigidbody(const ShapeType& shapeID, const glm::vec2& position, const
 	m_linearDrag = linearDrag;
 	m_angularDrag = angularDrag;
 	m_staticRigidbody = staticRigidbody;
+	m_store = nullptr;
+	m_storeIndex = 0;
+	m_previousPosition = position;
+	m_previousRotation = rotation;
+	m_awake = true;
+	m_restTime = 0.0f;
+	m_sleepLinearVelocity = DEFAULT_SLEEP_LINEAR_VELOCITY;
+	m_sleepAngularVelocity = DEFAULT_SLEEP_ANGULAR_VELOCITY;
+	m_sleepTime = DEFAULT_SLEEP_TIME;
+	m_sleepIsland = NO_ISLAND;
+	m_solverIndex = 0;
+	m_bullet = false;
 }
 Rigidbody::~Rigidbody()
 {
+	// the store can't be left holding a deleted rigidbody
+	if (m_store != nullptr)
+	{
+		m_store->Remove(m_storeIndex);
+	}
 }
 
 void Rigidbody::FixedUpdate(const glm::vec2& gravity, const float timeStep)
 {
-	if (m_kinematic || m_staticRigidbody)
+	// the store integrates all of its bodies at once
+	if (m_kinematic || m_staticRigidbody || !m_awake || m_store != nullptr)
 	{
 		return;
 	}
@@ -56,8 +72,8 @@ void Rigidbody::FixedUpdate(const glm::vec2& gravity, const float timeStep)
 void Rigidbody::Debug()
 {
 	//std::cout << "Shape ID: " << m_shapeID << std::endl;
-	std::cout << "Position: " << m_position.x << ", " << m_position.y << std::endl;
-	std::cout << "Velocity: " << m_velocity.x << ", " << m_velocity.y << std::endl;
+	std::cout << "Position: " << GetPosition().x << ", " << GetPosition().y << std::endl;
+	std::cout << "Velocity: " << GetVelocity().x << ", " << GetVelocity().y << std::endl;
 	//std::cout << "Rotation: " << m_rotation << std::endl;
 	//std::cout << "Angular Velocity: " << m_angularVelocity << std::endl;
 	//std::cout << "Mass: " << m_mass << std::endl;
@@ -74,45 +90,204 @@ void Rigidbody::ApplyForce(const glm::vec2& force, const glm::vec2& pos)
 		return;
 	}
 
-	// adds the instantaneous acceleration to the current velocity
-	m_velocity += force / m_mass;
+	// adds the instantaneous acceleration to the current velocity, which also wakes the rigidbody
+	SetVelocity(GetVelocity() + force / m_mass);
 	// adds the instantaneous acceleration to the angular velocity based on the position where the force is applied
-	m_angularVelocity += ((force.y * pos.x) - (force.x * pos.y)) / (m_moment);
+	SetAngularVelocity(GetAngularVelocity() + ((force.y * pos.x) - (force.x * pos.y)) / (m_moment));
+}
+
+void Rigidbody::AttachToStore(BodyStore * store)
+{
+	if (m_store == store)
+	{
+		return;
+	}
+	DetachFromStore();
+
+	// the store reads the state from the rigidbody, so it is only attached once the state has been copied
+	if (store != nullptr)
+	{
+		m_storeIndex = store->Add(this);
+		m_store = store;
+	}
+}
+void Rigidbody::DetachFromStore()
+{
+	if (m_store == nullptr)
+	{
+		return;
+	}
+
+	// copies the state back into the rigidbody before leaving the store
+	m_position = m_store->GetPosition(m_storeIndex);
+	m_velocity = m_store->GetVelocity(m_storeIndex);
+	m_rotation = m_store->GetRotation(m_storeIndex);
+	m_angularVelocity = m_store->GetAngularVelocity(m_storeIndex);
+	m_store->Remove(m_storeIndex);
+	m_store = nullptr;
+	m_storeIndex = 0;
+}
+
+void Rigidbody::SavePreviousState()
+{
+	m_previousPosition = GetPosition();
+	m_previousRotation = GetRotation();
+}
+glm::vec2 Rigidbody::GetInterpolatedPosition(const float alpha) const
+{
+	return m_previousPosition + (GetPosition() - m_previousPosition) * alpha;
+}
+float Rigidbody::GetInterpolatedRotation(const float alpha) const
+{
+	return m_previousRotation + (GetRotation() - m_previousRotation) * alpha;
+}
+
+void Rigidbody::SetAwake(const bool awake)
+{
+	if (awake == m_awake)
+	{
+		return;
+	}
+
+	m_awake = awake;
+	m_restTime = 0.0f;
+	if (!m_awake)
+	{
+		// sleeping rigidbodies don't move
+		if (m_store != nullptr)
+		{
+			m_store->SetVelocity(m_storeIndex, glm::vec2(0.0f, 0.0f));
+			m_store->SetAngularVelocity(m_storeIndex, 0.0f);
+		}
+		else
+		{
+			m_velocity = glm::vec2(0.0f, 0.0f);
+			m_angularVelocity = 0.0f;
+		}
+	}
+	UpdateStoreFlags();
+}
+void Rigidbody::SetSleepThreshold(const float linearVelocity, const float angularVelocity, const float sleepTime)
+{
+	m_sleepLinearVelocity = linearVelocity;
+	m_sleepAngularVelocity = angularVelocity;
+	m_sleepTime = sleepTime;
+}
+bool Rigidbody::UpdateRestTime(const float timeStep)
+{
+	// the rigidbody needs to stay still for the whole time, so the timer restarts whenever it moves too fast
+	if (glm::length(GetVelocity()) > m_sleepLinearVelocity || fabsf(GetAngularVelocity()) > m_sleepAngularVelocity)
+	{
+		m_restTime = 0.0f;
+		return false;
+	}
+
+	m_restTime += timeStep;
+	return m_restTime >= m_sleepTime;
 }
 
 void Rigidbody::SetPosition(const glm::vec2& position)
 {
+	SetAwake(true);
+	if (m_store != nullptr)
+	{
+		m_store->SetPosition(m_storeIndex, position);
+		return;
+	}
 	m_position = position;
 }
+glm::vec2 Rigidbody::GetPosition() const
+{
+	return (m_store != nullptr) ? m_store->GetPosition(m_storeIndex) : m_position;
+}
 void Rigidbody::SetVelocity(const glm::vec2 & velocity)
 {
+	SetAwake(true);
+	if (m_store != nullptr)
+	{
+		m_store->SetVelocity(m_storeIndex, velocity);
+		return;
+	}
 	m_velocity = velocity;
 }
+glm::vec2 Rigidbody::GetVelocity() const
+{
+	return (m_store != nullptr) ? m_store->GetVelocity(m_storeIndex) : m_velocity;
+}
 
 void Rigidbody::SetRotation(const float rotation)
 {
+	if (m_store != nullptr)
+	{
+		m_store->SetRotation(m_storeIndex, rotation);
+		return;
+	}
 	m_rotation = rotation;
 }
+float Rigidbody::GetRotation() const
+{
+	return (m_store != nullptr) ? m_store->GetRotation(m_storeIndex) : m_rotation;
+}
 void Rigidbody::SetAngularVelocity(const float angularVelocity)
 {
+	SetAwake(true);
+	if (m_store != nullptr)
+	{
+		m_store->SetAngularVelocity(m_storeIndex, angularVelocity);
+		return;
+	}
 	m_angularVelocity = angularVelocity;
 }
+float Rigidbody::GetAngularVelocity() const
+{
+	return (m_store != nullptr) ? m_store->GetAngularVelocity(m_storeIndex) : m_angularVelocity;
+}
 
 void Rigidbody::SetMass(const float mass)
 {
 	m_mass = mass;
+	if (m_store != nullptr)
+	{
+		m_store->SetInverseMass(m_storeIndex, (m_staticRigidbody || m_mass == 0.0f) ? 0.0f : 1.0f / m_mass);
+	}
 }
 
 void Rigidbody::SetLinearDrag(const float linearDrag)
 {
 	m_linearDrag = linearDrag;
+	if (m_store != nullptr)
+	{
+		m_store->SetLinearDrag(m_storeIndex, m_linearDrag);
+	}
 }
 void Rigidbody::SetAngularDrag(const float angularDrag)
 {
 	m_angularDrag = angularDrag;
+	if (m_store != nullptr)
+	{
+		m_store->SetAngularDrag(m_storeIndex, m_angularDrag);
+	}
 }
 
 void Rigidbody::SetStatic(const bool staticRigidbody)
 {
 	m_staticRigidbody = staticRigidbody;
+	if (m_store != nullptr)
+	{
+		m_store->SetInverseMass(m_storeIndex, (m_staticRigidbody || m_mass == 0.0f) ? 0.0f : 1.0f / m_mass);
+	}
+	UpdateStoreFlags();
+}
+void Rigidbody::SetKinematic(const bool kinematic)
+{
+	m_kinematic = kinematic;
+	UpdateStoreFlags();
+}
+
+void Rigidbody::UpdateStoreFlags()
+{
+	if (m_store != nullptr)
+	{
+		m_store->SetDynamic(m_storeIndex, !(m_kinematic || m_staticRigidbody) && m_awake);
+	}
 }
\ No newline at end of file
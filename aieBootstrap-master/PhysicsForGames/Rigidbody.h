@@ -2,6 +2,18 @@
 
 #include "PhysicsObject.h"
 
+// velocities below these are set to 0
+#define MIN_LINEAR_THRESHOLD 0.0001f
+#define MIN_ROTATION_THRESHOLD 0.00001f
+// a rigidbody can fall asleep once its velocities have stayed below these for the sleep time
+#define DEFAULT_SLEEP_LINEAR_VELOCITY 0.2f
+#define DEFAULT_SLEEP_ANGULAR_VELOCITY 0.2f
+#define DEFAULT_SLEEP_TIME 0.5f
+// the island of a rigidbody that isn't asleep
+#define NO_ISLAND -1
+
+class BodyStore;
+
 class Rigidbody : public PhysicsObject
 {
 public:
@@ -16,16 +28,54 @@ public:
 	virtual void Debug();
 	// applys a force to the object
 	void ApplyForce(const glm::vec2& force, const glm::vec2& pos);
+	// gets the point of the shape furthest along the direction, used by GJK to collide any two convex shapes
+	virtual glm::vec2 Support(const glm::vec2& direction) const = 0;
+
+	// moves the state of the rigidbody into the store, the rigidbody then reads and writes its state from there
+	void AttachToStore(BodyStore* store);
+	// copies the state back out of the store and removes the rigidbody from it
+	void DetachFromStore();
+	// used by the store when the rigidbody's state is moved to a different index
+	void SetStoreIndex(const unsigned int index) { m_storeIndex = index; }
+	BodyStore* GetStore() const { return m_store; }
+	// the index of the rigidbody in the contact solver, only valid while the solver holds the rigidbody at that index
+	void SetSolverIndex(const unsigned int index) { m_solverIndex = index; }
+	unsigned int GetSolverIndex() const { return m_solverIndex; }
+
+	// sleeping rigidbodies are not integrated and are only checked for collision against awake rigidbodies
+	// applying a force or setting the position or velocity wakes the rigidbody up
+	void SetAwake(const bool awake);
+	bool GetAwake() const { return m_awake; }
+	// changes how still the rigidbody needs to be and for how long before it can fall asleep
+	void SetSleepThreshold(const float linearVelocity, const float angularVelocity, const float sleepTime);
+	// adds to the time the rigidbody has been resting, returns true once it has rested for long enough to sleep
+	bool UpdateRestTime(const float timeStep);
+	// the island that the rigidbody fell asleep with, the scene wakes the whole island when one of them is woken
+	void SetSleepIsland(const int island) { m_sleepIsland = island; }
+	int GetSleepIsland() const { return m_sleepIsland; }
+
+	// stores the current position and rotation as the previous state, called by the scene before each fixed step
+	void SavePreviousState();
+	// blends between the previous and current state, 0 is the previous state and 1 is the current state
+	glm::vec2 GetInterpolatedPosition(const float alpha) const;
+	float GetInterpolatedRotation(const float alpha) const;
+	// the position before the last fixed step
+	glm::vec2 GetPreviousPosition() const { return m_previousPosition; }
+
+	// bullets are swept from where they were before the step to where they are now, so they can't pass through planes
+	// and boxes when they move further than their size in one step, only the rigidbodies marked as bullets pay for the sweep
+	void SetBullet(const bool bullet) { m_bullet = bullet; }
+	bool GetBullet() const { return m_bullet; }
 
 	void SetPosition(const glm::vec2& position);
-	glm::vec2 GetPosition() const { return m_position; }
+	glm::vec2 GetPosition() const;
 	void SetVelocity(const glm::vec2& velocity);
-	glm::vec2 GetVelocity() const { return m_velocity; }
+	glm::vec2 GetVelocity() const;
 		
 	void SetRotation(const float rotation);
-	float GetRotation() const { return m_rotation; }
+	float GetRotation() const;
 	void SetAngularVelocity(const float angularVelocity);
-	float GetAngularVelocity() const { return m_angularVelocity; }
+	float GetAngularVelocity() const;
 	float GetMoment() const { return m_moment; }
 	
 	// use for when mass is lost, i.e. when a rocket uses up fuel
@@ -40,10 +90,34 @@ public:
 
 	void SetStatic(const bool staticRigidbody);
 	bool GetStatic() const { return m_staticRigidbody; }
+	virtual void SetKinematic(const bool kinematic);
+
+protected:
+	// updates the flag in the store that says if the rigidbody needs to be integrated
+	void UpdateStoreFlags();
 
 protected:
-	// stores the object's location
+	// the store that holds the state while the rigidbody is attached to one
+	BodyStore* m_store;
+	// where the state is stored in the store
+	unsigned int m_storeIndex;
+	// stores the object's location, only used when the rigidbody isn't attached to a store
 	glm::vec2 m_position;
+	// set by the contact solver
+	unsigned int m_solverIndex;
+	// sleeping rigidbodies are not simulated
+	bool m_awake;
+	// how long the velocities have been below the sleep thresholds
+	float m_restTime;
+	float m_sleepLinearVelocity;
+	float m_sleepAngularVelocity;
+	float m_sleepTime;
+	int m_sleepIsland;
+	// continuous collision is used for this rigidbody
+	bool m_bullet;
+	// the position and rotation before the last fixed step, used to draw the object between steps
+	glm::vec2 m_previousPosition;
+	float m_previousRotation;
 	// stores the directional speed
 	glm::vec2 m_velocity;
 	// stores the weight of the object
@@ -0,0 +1,77 @@
+#include "Simd.h"
+
+#if SIMD_X86
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if SIMD_X86
+// fills registers with the result of the cpuid instruction for the leaf
+static void CpuId(const unsigned int leaf, unsigned int registers[4])
+{
+#if defined(_MSC_VER)
+	int result[4];
+	__cpuidex(result, leaf, 0);
+	for (int i = 0; i < 4; i++)
+	{
+		registers[i] = (unsigned int)result[i];
+	}
+#else
+	__cpuid_count(leaf, 0, registers[0], registers[1], registers[2], registers[3]);
+#endif
+}
+
+// gets the register state that the operating system saves on a context switch
+static unsigned long long GetXcr0()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned int eax, edx;
+	__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+	return ((unsigned long long)edx << 32) | eax;
+#endif
+}
+
+static SimdLevel DetectSimdLevel()
+{
+	unsigned int registers[4];
+	CpuId(0, registers);
+	unsigned int maxLeaf = registers[0];
+
+	CpuId(1, registers);
+	// edx bit 26
+	bool sse2 = (registers[3] & (1 << 26)) != 0;
+	// ecx bit 27, the operating system uses xsave so xgetbv can be used
+	bool osxsave = (registers[2] & (1 << 27)) != 0;
+	if (!sse2)
+	{
+		return SIMD_NONE;
+	}
+
+	// the operating system needs to save the xmm and ymm registers for avx to be usable
+	if (osxsave && maxLeaf >= 7 && (GetXcr0() & 6) == 6)
+	{
+		CpuId(7, registers);
+		// ebx bit 5
+		if ((registers[1] & (1 << 5)) != 0)
+		{
+			return SIMD_AVX2;
+		}
+	}
+	return SIMD_SSE2;
+}
+#endif
+
+SimdLevel GetSimdLevel()
+{
+#if SIMD_X86
+	static const SimdLevel level = DetectSimdLevel();
+	return level;
+#else
+	return SIMD_NONE;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+// the vector instruction sets that the physics kernels can use
+enum SimdLevel
+{
+	SIMD_NONE = 0, // plain scalar code
+	SIMD_SSE2, // 4 floats per instruction
+	SIMD_AVX2 // 8 floats per instruction
+};
+
+// the intrinsics are only available when compiling for x86
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SIMD_X86 0
+#endif
+
+// msvc allows avx2 intrinsics in any function, gcc and clang need the function to be marked
+#if defined(_MSC_VER)
+#define SIMD_AVX2_FUNCTION
+#else
+#define SIMD_AVX2_FUNCTION __attribute__((target("avx2")))
+#endif
+
+// gets the best instruction set supported by the cpu and operating system, checked once with cpuid
+SimdLevel GetSimdLevel();
\ No newline at end of file
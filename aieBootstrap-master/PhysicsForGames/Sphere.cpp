@@ -22,10 +22,27 @@ Sphere::~Sphere()
 {
 }
 
-void Sphere::MakeGizmo()
+void Sphere::MakeGizmo(const float alpha)
 {
 	// uses gizmos to draw a circle
-	aie::Gizmos::add2DCircle(m_position, m_radius, 24, m_colour);
+	aie::Gizmos::add2DCircle(GetInterpolatedPosition(alpha), m_radius, 24, m_colour);
+}
+
+Bounds Sphere::GetBounds() const
+{
+	Bounds bounds;
+	bounds.min = GetPosition() - glm::vec2(m_radius, m_radius);
+	bounds.max = GetPosition() + glm::vec2(m_radius, m_radius);
+	return bounds;
+}
+glm::vec2 Sphere::Support(const glm::vec2 & direction) const
+{
+	float length = glm::length(direction);
+	if (length == 0.0f)
+	{
+		return GetPosition();
+	}
+	return GetPosition() + direction * (m_radius / length);
 }
 
 void Sphere::SetRadius(const float radius)
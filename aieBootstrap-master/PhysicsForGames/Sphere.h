@@ -1,11 +1,15 @@
 #pragma once
 
 #include "Rigidbody.h"
+#include "ObjectPool.h"
 
 // circle
 class Sphere : public Rigidbody
 {
 public:
+	// the shape type of every object of this class, used to cast to this class without RTTI
+	static const ShapeType SHAPE_TYPE = SPHERE;
+
 	Sphere(const glm::vec2& position, const glm::vec2& velocity, const float radius, const float mass,
 		const glm::vec4& colour = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), const bool kinematic = false, const bool staticRigidbody = false,
 		const float elasticity = 1.0f, const float linearDrag = 0.0f, const float angularDrag = 0.0f, const float s = 0.0f, const float k = 0.0f);
@@ -15,8 +19,16 @@ public:
 		const float elasticity = 1.0f, const float linearDrag = 0.0f, const float angularDrag = 0.0f, const float s = 0.0f, const float k = 0.0f);
 	~Sphere();
 
+	// the memory comes from a pool so that spawning and removing spheres doesn't use the heap each time
+	static void* operator new(size_t size) { return ObjectPool<Sphere>::Get().Allocate(size); }
+	static void operator delete(void* memory, size_t size) { ObjectPool<Sphere>::Get().Deallocate(memory, size); }
+
 	// draws the circle
-	virtual void MakeGizmo();
+	virtual void MakeGizmo(const float alpha);
+	// gets the box around the circle
+	virtual Bounds GetBounds() const;
+	// gets the point on the edge of the circle in the direction
+	virtual glm::vec2 Support(const glm::vec2& direction) const;
 
 	void SetRadius(const float radius);
 	float GetRadius() const { return m_radius; }
@@ -0,0 +1,158 @@
+#include "SphereBatch.h"
+
+// how much further apart than touching, relative to the squared radii, a pair can be and still be let through
+// the squared distance and the distance Sphere2Sphere compares are each rounded differently, this covers the few ulps between them
+#define SPHERE_BATCH_TOLERANCE 1.0e-5f
+
+// for each mask of 8 pairs, the lanes of the overlapping pairs moved to the front and how many there are
+// lets the avx2 path write out the overlapping pairs of a group with one shuffle instead of a loop
+struct CompactTable
+{
+	CompactTable()
+	{
+		for (unsigned int mask = 0; mask < 256; mask++)
+		{
+			unsigned int count = 0;
+			for (unsigned int lane = 0; lane < 8; lane++)
+			{
+				lanes[mask][lane] = 0;
+				if ((mask >> lane) & 1)
+				{
+					lanes[mask][count++] = lane;
+				}
+			}
+			counts[mask] = count;
+		}
+	}
+
+	int lanes[256][8];
+	unsigned int counts[256];
+};
+static const CompactTable compactTable;
+
+SphereBatch::SphereBatch()
+{
+	m_overlapCount = 0;
+	m_simdLevel = ::GetSimdLevel();
+}
+SphereBatch::~SphereBatch()
+{
+}
+
+void SphereBatch::Clear()
+{
+	// clearing keeps the capacity, so the arrays stop allocating once they have grown to the size of the largest batch
+	m_pairs.clear();
+	m_positionX1.clear();
+	m_positionY1.clear();
+	m_positionX2.clear();
+	m_positionY2.clear();
+	m_radii.clear();
+	m_overlapCount = 0;
+}
+void SphereBatch::Add(const unsigned int pair, const glm::vec2 & position1, const glm::vec2 & position2, const float radii)
+{
+	m_pairs.push_back(pair);
+	m_positionX1.push_back(position1.x);
+	m_positionY1.push_back(position1.y);
+	m_positionX2.push_back(position2.x);
+	m_positionY2.push_back(position2.y);
+	m_radii.push_back(radii);
+}
+void SphereBatch::Filter()
+{
+	unsigned int count = m_pairs.size();
+	if (m_overlaps.size() < count)
+	{
+		m_overlaps.resize(count);
+	}
+	m_overlapCount = 0;
+
+	// the simd paths leave the pairs that don't fill a whole register for the scalar loop
+	unsigned int filtered = 0;
+	if (m_simdLevel == SIMD_AVX2)
+	{
+		filtered = FilterAVX2(0, count);
+	}
+	else if (m_simdLevel == SIMD_SSE2)
+	{
+		filtered = FilterSSE2(0, count);
+	}
+	FilterScalar(filtered, count);
+}
+
+void SphereBatch::SetSimdLevel(const SimdLevel simdLevel)
+{
+	SimdLevel supported = ::GetSimdLevel();
+	m_simdLevel = (simdLevel > supported) ? supported : simdLevel;
+}
+
+void SphereBatch::FilterScalar(const unsigned int begin, const unsigned int end)
+{
+	for (unsigned int i = begin; i < end; i++)
+	{
+		float distanceX = m_positionX2[i] - m_positionX1[i];
+		float distanceY = m_positionY2[i] - m_positionY1[i];
+		float radii = m_radii[i] * m_radii[i];
+		// the pair is always written and the count only moves past it if it overlaps, so there is no branch to mispredict
+		m_overlaps[m_overlapCount] = m_pairs[i];
+		m_overlapCount += (distanceX * distanceX + distanceY * distanceY <= radii + radii * SPHERE_BATCH_TOLERANCE) ? 1 : 0;
+	}
+}
+
+// the simd paths do the same check as the scalar loop on 4 or 8 pairs at once and then write out the pairs that overlap
+// the overlap count never gets ahead of the pair being written, so the overlaps never need more room than the pairs
+unsigned int SphereBatch::FilterSSE2(const unsigned int begin, const unsigned int end)
+{
+#if SIMD_X86
+	const __m128 tolerance = _mm_set1_ps(SPHERE_BATCH_TOLERANCE);
+
+	unsigned int stop = begin + ((end - begin) & ~3u);
+	for (unsigned int i = begin; i < stop; i += 4)
+	{
+		__m128 distanceX = _mm_sub_ps(_mm_loadu_ps(&m_positionX2[i]), _mm_loadu_ps(&m_positionX1[i]));
+		__m128 distanceY = _mm_sub_ps(_mm_loadu_ps(&m_positionY2[i]), _mm_loadu_ps(&m_positionY1[i]));
+		__m128 radii = _mm_loadu_ps(&m_radii[i]);
+		radii = _mm_mul_ps(radii, radii);
+		__m128 distance = _mm_add_ps(_mm_mul_ps(distanceX, distanceX), _mm_mul_ps(distanceY, distanceY));
+		int overlapping = _mm_movemask_ps(_mm_cmple_ps(distance, _mm_add_ps(radii, _mm_mul_ps(radii, tolerance))));
+
+		for (unsigned int j = 0; j < 4; j++)
+		{
+			m_overlaps[m_overlapCount] = m_pairs[i + j];
+			m_overlapCount += (overlapping >> j) & 1;
+		}
+	}
+	return stop;
+#else
+	return begin;
+#endif
+}
+
+// the same as FilterSSE2 with 8 pairs at a time, the overlapping pairs are shuffled to the front of the group and written together
+// the write always stores 8 pairs, the ones past the overlapping pairs are overwritten by the next group
+SIMD_AVX2_FUNCTION unsigned int SphereBatch::FilterAVX2(const unsigned int begin, const unsigned int end)
+{
+#if SIMD_X86
+	const __m256 tolerance = _mm256_set1_ps(SPHERE_BATCH_TOLERANCE);
+
+	unsigned int stop = begin + ((end - begin) & ~7u);
+	for (unsigned int i = begin; i < stop; i += 8)
+	{
+		__m256 distanceX = _mm256_sub_ps(_mm256_loadu_ps(&m_positionX2[i]), _mm256_loadu_ps(&m_positionX1[i]));
+		__m256 distanceY = _mm256_sub_ps(_mm256_loadu_ps(&m_positionY2[i]), _mm256_loadu_ps(&m_positionY1[i]));
+		__m256 radii = _mm256_loadu_ps(&m_radii[i]);
+		radii = _mm256_mul_ps(radii, radii);
+		__m256 distance = _mm256_add_ps(_mm256_mul_ps(distanceX, distanceX), _mm256_mul_ps(distanceY, distanceY));
+		int overlapping = _mm256_movemask_ps(_mm256_cmp_ps(distance, _mm256_add_ps(radii, _mm256_mul_ps(radii, tolerance)), _CMP_LE_OQ));
+
+		__m256i pairs = _mm256_loadu_si256((const __m256i*)&m_pairs[i]);
+		__m256i lanes = _mm256_loadu_si256((const __m256i*)compactTable.lanes[overlapping]);
+		_mm256_storeu_si256((__m256i*)&m_overlaps[m_overlapCount], _mm256_permutevar8x32_epi32(pairs, lanes));
+		m_overlapCount += compactTable.counts[overlapping];
+	}
+	return stop;
+#else
+	return begin;
+#endif
+}
\ No newline at end of file
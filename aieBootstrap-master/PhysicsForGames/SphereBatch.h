@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+#include "PhysicsObject.h"
+#include "Simd.h"
+
+// checks a batch of circle pairs from the broadphase for overlap several pairs at a time, so only the pairs that overlap
+// are passed on to Sphere2Sphere to work out the contact
+// the pairs are stored as arrays of each value (structure of arrays) so the simd paths can load 4 or 8 pairs at once
+class SphereBatch
+{
+public:
+	SphereBatch();
+	~SphereBatch();
+
+	// removes the pairs from the last batch
+	void Clear();
+	// adds a pair of circles, the pair is the number used to refer to the pair when it is found to overlap
+	void Add(const unsigned int pair, const glm::vec2& position1, const glm::vec2& position2, const float radii);
+	// finds the pairs whose circles overlap, they are kept in the order they were added
+	// the check uses the squared distance so it doesn't need a square root, and it lets through the pairs that are
+	// within rounding of touching so that it never drops a pair that Sphere2Sphere would find a contact for
+	void Filter();
+
+	// limits the instruction set used by Filter, levels the cpu doesn't support are lowered to the best one it does
+	void SetSimdLevel(const SimdLevel simdLevel);
+	SimdLevel GetSimdLevel() const { return m_simdLevel; }
+
+	// the amount of pairs added since the batch was cleared
+	unsigned int GetCount() const { return m_pairs.size(); }
+	// the pairs found to overlap by the last call to Filter
+	unsigned int GetOverlapCount() const { return m_overlapCount; }
+	const unsigned int* GetOverlaps() const { return m_overlaps.data(); }
+
+protected:
+	// check the pairs from begin up to but not including end and write the overlapping ones to the overlaps
+	// the simd paths check groups of 4 or 8 and return the index they stopped at, the rest are left for the scalar loop
+	void FilterScalar(const unsigned int begin, const unsigned int end);
+	unsigned int FilterSSE2(const unsigned int begin, const unsigned int end);
+	unsigned int FilterAVX2(const unsigned int begin, const unsigned int end);
+
+protected:
+	std::vector<unsigned int> m_pairs;
+	std::vector<float> m_positionX1;
+	std::vector<float> m_positionY1;
+	std::vector<float> m_positionX2;
+	std::vector<float> m_positionY2;
+	// the sum of the radii of the two circles
+	std::vector<float> m_radii;
+	// the pairs that overlap, the first overlap count are from the last call to Filter
+	std::vector<unsigned int> m_overlaps;
+	unsigned int m_overlapCount;
+	// the instruction set used by Filter
+	SimdLevel m_simdLevel;
+};
\ No newline at end of file
@@ -0,0 +1,85 @@
+#include "StepArena.h"
+#include <algorithm>
+
+// the size of the first block, enough for the collision functions of a few thousand pairs
+#define DEFAULT_BLOCK_SIZE 65536
+
+StepArena::StepArena()
+{
+	m_block = 0;
+	m_offset = 0;
+	m_used = 0;
+}
+StepArena::~StepArena()
+{
+	for (Block& block : m_blocks)
+	{
+		delete[] block.memory;
+	}
+	m_blocks.clear();
+}
+
+void* StepArena::Allocate(const size_t size, const size_t alignment)
+{
+	while (true)
+	{
+		if (m_block == m_blocks.size())
+		{
+			// the extra alignment makes sure the allocation fits wherever the block starts
+			AddBlock(std::max((size_t)DEFAULT_BLOCK_SIZE, size + alignment));
+		}
+
+		// the blocks are allocated with the largest alignment, so aligning the offset aligns the address
+		Block& block = m_blocks[m_block];
+		size_t offset = (m_offset + alignment - 1) & ~(alignment - 1);
+		if (offset + size <= block.size)
+		{
+			m_offset = offset + size;
+			m_used += size;
+			return block.memory + offset;
+		}
+
+		// the rest of the block is wasted until the arena is reset
+		m_block++;
+		m_offset = 0;
+	}
+}
+void StepArena::Reset()
+{
+	// replaces the blocks with one block that fits everything the step used
+	if (m_block > 0)
+	{
+		size_t capacity = GetCapacity();
+		for (Block& block : m_blocks)
+		{
+			delete[] block.memory;
+		}
+		m_blocks.clear();
+		AddBlock(capacity);
+	}
+
+	m_block = 0;
+	m_offset = 0;
+	m_used = 0;
+}
+
+size_t StepArena::GetCapacity() const
+{
+	size_t capacity = 0;
+	for (const Block& block : m_blocks)
+	{
+		capacity += block.size;
+	}
+	return capacity;
+}
+
+StepArena & StepArena::GetThreadArena()
+{
+	thread_local StepArena arena;
+	return arena;
+}
+
+void StepArena::AddBlock(const size_t size)
+{
+	m_blocks.push_back({ new unsigned char[size], size });
+}
\ No newline at end of file
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+// an array of objects allocated from a step arena, only valid until the arena is reset
+template<typename T>
+struct ScratchArray
+{
+	T* data;
+	unsigned int count;
+
+	T* begin() const { return data; }
+	T* end() const { return data + count; }
+	unsigned int size() const { return count; }
+	T& operator[](const unsigned int index) const { return data[index]; }
+};
+
+// hands out memory for data that is only needed during a physics step by moving an offset along a block of memory
+// nothing is freed until the arena is reset at the end of the step, so an allocation is only a few additions and the
+// collision functions never need the heap once the blocks are big enough for a whole step
+// each thread has its own arena so the narrowphase threads can allocate without locking
+// the objects are never destroyed, so only types that don't need a destructor should be allocated from it
+class StepArena
+{
+public:
+	StepArena();
+	~StepArena();
+
+	// gets uninitialised memory for the amount of objects
+	template<typename T>
+	ScratchArray<T> Allocate(const unsigned int count)
+	{
+		return { static_cast<T*>(Allocate(sizeof(T) * count, alignof(T))), count };
+	}
+	void* Allocate(const size_t size, const size_t alignment);
+	// frees everything allocated since the last reset
+	// if the step needed more than one block they are replaced by one block that fits all of them, so the next step doesn't
+	// have to use the heap
+	void Reset();
+
+	// the total size of the blocks
+	size_t GetCapacity() const;
+	// the amount of memory handed out since the last reset
+	size_t GetUsed() const { return m_used; }
+
+	// the arena used by the calling thread
+	static StepArena& GetThreadArena();
+
+protected:
+	// a piece of memory that the allocations are taken from
+	struct Block
+	{
+		unsigned char* memory;
+		size_t size;
+	};
+
+protected:
+	// adds a block that is at least the size
+	void AddBlock(const size_t size);
+
+protected:
+	std::vector<Block> m_blocks;
+	// the block being allocated from
+	unsigned int m_block;
+	// where the next allocation starts in the current block
+	size_t m_offset;
+	size_t m_used;
+};
\ No newline at end of file
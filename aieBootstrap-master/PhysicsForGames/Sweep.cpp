@@ -0,0 +1,90 @@
+#include "Sweep.h"
+
+// how small the displacement along an axis can be before the segment is treated as parallel to it
+#define SWEEP_EPSILON 1.0e-12f
+
+SweepSegment::SweepSegment()
+{
+	start = glm::vec2(0.0f, 0.0f);
+	displacement = glm::vec2(0.0f, 0.0f);
+	lengthSquared = 0.0f;
+	inverse = glm::vec2(0.0f, 0.0f);
+}
+SweepSegment::SweepSegment(const glm::vec2 & segmentStart, const glm::vec2 & segmentDisplacement)
+{
+	start = segmentStart;
+	displacement = segmentDisplacement;
+	lengthSquared = displacement.x * displacement.x + displacement.y * displacement.y;
+	for (int axis = 0; axis < 2; axis++)
+	{
+		float parallel = 1.0f / SWEEP_EPSILON;
+		inverse[axis] = (fabsf(displacement[axis]) < SWEEP_EPSILON) ? (displacement[axis] < 0.0f ? -parallel : parallel) : 1.0f / displacement[axis];
+	}
+}
+
+// the distance to the circle is measured from the closest point on the line, because the usual b * b - a * c loses most of
+// its precision when the segment is long compared to the circle
+// the simd paths of the ray batch do the same sums in the same order, so they agree with this on every circle
+bool SweepCircle(const SweepSegment & segment, const glm::vec2 & centre, const float radius, float & fraction)
+{
+	float offsetX = segment.start.x - centre.x;
+	float offsetY = segment.start.y - centre.y;
+	float b = offsetX * segment.displacement.x + offsetY * segment.displacement.y;
+	float c = (offsetX * offsetX + offsetY * offsetY) - radius * radius;
+	// the fraction where the line is closest to the centre
+	float closest = -b / segment.lengthSquared;
+	float closestX = offsetX + segment.displacement.x * closest;
+	float closestY = offsetY + segment.displacement.y * closest;
+	float h = radius * radius - (closestX * closestX + closestY * closestY);
+	// starts inside the circle, moves away from it or misses it
+	if (!(c > 0.0f && b < 0.0f && h >= 0.0f))
+	{
+		return false;
+	}
+	float t = closest - sqrtf(h / segment.lengthSquared);
+	if (!(t <= 1.0f))
+	{
+		return false;
+	}
+	fraction = t;
+	return true;
+}
+
+// the same as a point hitting the box grown by the radius with rounded corners, the point is found hitting the box grown
+// by the radius and if that is past a corner it is moved on to where it hits the circle around the corner
+bool SweepBox(const SweepSegment & segment, const float radius, const glm::vec2 & min, const glm::vec2 & max, float & fraction, glm::vec2 & normal)
+{
+	float enterX, enterY, exit;
+	ClipBox(segment, glm::vec2(min.x - radius, min.y - radius), glm::vec2(max.x + radius, max.y + radius), enterX, enterY, exit);
+	float enter = fmaxf(enterX, enterY);
+	if (!(enter <= exit && enter <= 1.0f && exit > 0.0f))
+	{
+		return false;
+	}
+
+	// a circle can start inside the grown box without touching the box if it is past one of the corners
+	glm::vec2 point = segment.start + segment.displacement * fmaxf(enter, 0.0f);
+	bool outsideX = point.x < min.x || point.x > max.x;
+	bool outsideY = point.y < min.y || point.y > max.y;
+	if (radius == 0.0f || !outsideX || !outsideY)
+	{
+		// hit a side, starting between the sides means it already overlaps the box
+		if (enter <= 0.0f)
+		{
+			return false;
+		}
+		fraction = enter;
+		// the side hit is on the axis the segment entered last
+		normal = (enterX >= enterY) ? glm::vec2(segment.inverse.x > 0.0f ? -1.0f : 1.0f, 0.0f) : glm::vec2(0.0f, segment.inverse.y > 0.0f ? -1.0f : 1.0f);
+		return true;
+	}
+
+	// past a corner, the only way to the box from there is through the circle around the corner
+	glm::vec2 corner = glm::vec2(point.x < min.x ? min.x : max.x, point.y < min.y ? min.y : max.y);
+	if (!SweepCircle(segment, corner, radius, fraction))
+	{
+		return false;
+	}
+	normal = (segment.start + segment.displacement * fraction - corner) / radius;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "PhysicsObject.h"
+
+// a point moving from the start along the displacement, with the values every sweep needs worked out once
+// the bullets, the broadphase queries and the ray batch all sweep with this, so they agree on what a segment hits
+struct SweepSegment
+{
+	SweepSegment();
+	SweepSegment(const glm::vec2& segmentStart, const glm::vec2& segmentDisplacement);
+
+	glm::vec2 start;
+	glm::vec2 displacement;
+	// the squared length of the displacement
+	float lengthSquared;
+	// 1 over the displacement along each axis, an axis the segment is parallel to gets a huge value with the sign of the
+	// displacement, so the fractions of the sides come out huge and on the right side of 0 instead of infinite or not a number
+	glm::vec2 inverse;
+};
+
+// gets the fractions of the line through the segment where it crosses into the box along each axis and the first fraction
+// it crosses out along either axis (slab test), the line is inside the box from the larger enter fraction to the exit
+inline void ClipBox(const SweepSegment& segment, const glm::vec2& min, const glm::vec2& max, float& enterX, float& enterY, float& exit)
+{
+	float nearX = (min.x - segment.start.x) * segment.inverse.x;
+	float farX = (max.x - segment.start.x) * segment.inverse.x;
+	float nearY = (min.y - segment.start.y) * segment.inverse.y;
+	float farY = (max.y - segment.start.y) * segment.inverse.y;
+	enterX = fminf(nearX, farX);
+	enterY = fminf(nearY, farY);
+	exit = fminf(fmaxf(nearX, farX), fmaxf(nearY, farY));
+}
+
+// finds the fraction of the segment at which a point moving along it first touches the circle
+// returns false if the point starts touching the circle or doesn't reach it
+bool SweepCircle(const SweepSegment& segment, const glm::vec2& centre, const float radius, float& fraction);
+// finds the fraction of the segment at which a circle of the radius moving along it first touches the box, and the normal
+// of the box where it touches, 0 sweeps a point
+// returns false if the circle starts touching the box or doesn't reach it
+bool SweepBox(const SweepSegment& segment, const float radius, const glm::vec2& min, const glm::vec2& max, float& fraction, glm::vec2& normal);
\ No newline at end of file
@@ -0,0 +1,424 @@
+#include "SweepAndPrune.h"
+#include <algorithm>
+
+// if more actors than this are added between steps then sorting from scratch is faster than insertion sort
+#define REBUILD_THRESHOLD 64
+// marks an index that doesn't have an actor from the last call to FindPairs
+#define NO_INDEX 0xFFFFFFFF
+
+SweepAndPrune::SweepAndPrune()
+{
+	m_actorCount = 0;
+	m_removalsPending = false;
+	m_maxSize = glm::vec2(0.0f, 0.0f);
+}
+SweepAndPrune::~SweepAndPrune()
+{
+}
+
+void SweepAndPrune::FindPairs(const std::vector<PhysicsObject*>& actors, std::vector<CollisionPair>& pairs)
+{
+	pairs.clear();
+	m_changes.clear();
+	m_unbounded.clear();
+
+	unsigned int actorCount = actors.size();
+	// gets the bounds of every actor for this step
+	m_bounds.resize(actorCount);
+	m_maxSize = glm::vec2(0.0f, 0.0f);
+	for (unsigned int i = 0; i < actorCount; i++)
+	{
+		m_bounds[i] = GetActorBounds(actors[i]);
+		if (actors[i]->GetShapeType() == PLANE)
+		{
+			m_unbounded.push_back(i);
+		}
+		else
+		{
+			m_maxSize = glm::max(m_maxSize, m_bounds[i].max - m_bounds[i].min);
+		}
+	}
+
+	// finds the actors that don't have endpoints yet, a removal can move a new actor into the gap of an old one
+	m_newActors.clear();
+	unsigned int knownCount = m_actorCount;
+	if (m_removalsPending)
+	{
+		ApplyRemovals();
+		knownCount = m_oldIndices.size();
+		for (unsigned int i = 0; i < knownCount; i++)
+		{
+			if (m_oldIndices[i] == NO_INDEX)
+			{
+				m_newActors.push_back(i);
+			}
+		}
+	}
+	for (unsigned int i = knownCount; i < actorCount; i++)
+	{
+		m_newActors.push_back(i);
+	}
+
+	// sorts from scratch on the first step or when a lot of actors have been added
+	if (m_actorCount == 0 || actorCount < knownCount || m_newActors.size() > REBUILD_THRESHOLD)
+	{
+		m_actorCount = actorCount;
+		Rebuild();
+	}
+	else
+	{
+		// moves the existing endpoints to where the actors are now
+		for (unsigned int axis = 0; axis < 2; axis++)
+		{
+			for (Endpoint& endpoint : m_endpoints[axis])
+			{
+				const Bounds& bounds = m_bounds[endpoint.index];
+				endpoint.value = endpoint.isMax ? bounds.max[axis] : bounds.min[axis];
+			}
+		}
+
+		// adds the endpoints of new actors to the end of the lists, the insertion sort then moves them into place
+		// starting at the end means they start off not overlapping anything, which keeps the pairs consistent
+		for (unsigned int i : m_newActors)
+		{
+			if (actors[i]->GetShapeType() == PLANE)
+			{
+				continue;
+			}
+			for (unsigned int axis = 0; axis < 2; axis++)
+			{
+				m_endpoints[axis].push_back({ m_bounds[i].min[axis], i, false });
+				m_endpoints[axis].push_back({ m_bounds[i].max[axis], i, true });
+			}
+		}
+		m_actorCount = actorCount;
+
+		SortAxis(0);
+		SortAxis(1);
+	}
+
+	// a pair can be added and removed more than once in a step, so the changes are summed to get the overall result
+	m_addedPairs.clear();
+	m_removedPairs.clear();
+	std::sort(m_changes.begin(), m_changes.end());
+	for (unsigned int i = 0; i < m_changes.size();)
+	{
+		unsigned long long key = m_changes[i].first;
+		int change = 0;
+		for (; i < m_changes.size() && m_changes[i].first == key; i++)
+		{
+			change += m_changes[i].second;
+		}
+
+		CollisionPair pair = { (unsigned int)(key >> 32), (unsigned int)(key & 0xFFFFFFFF) };
+		if (change > 0)
+		{
+			m_addedPairs.push_back(pair);
+		}
+		else if (change < 0)
+		{
+			m_removedPairs.push_back(pair);
+		}
+	}
+
+	// the overlapping pairs are passed to the narrowphase
+	for (unsigned long long key : m_overlaps)
+	{
+		pairs.push_back({ (unsigned int)(key >> 32), (unsigned int)(key & 0xFFFFFFFF) });
+	}
+	// planes have no endpoints so they are paired with every other actor
+	for (unsigned int plane : m_unbounded)
+	{
+		for (unsigned int i = 0; i < actorCount; i++)
+		{
+			if (actors[i]->GetShapeType() != PLANE)
+			{
+				pairs.push_back({ std::min(plane, i), std::max(plane, i) });
+			}
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end(), ComparePairs);
+}
+
+void SweepAndPrune::OnActorRemoved(const unsigned int index, const unsigned int last)
+{
+	// starts tracking where the actors from the last call to FindPairs have gone
+	if (!m_removalsPending)
+	{
+		m_oldIndices.resize(m_actorCount);
+		m_newIndices.resize(m_actorCount);
+		for (unsigned int i = 0; i < m_actorCount; i++)
+		{
+			m_oldIndices[i] = i;
+			m_newIndices[i] = i;
+		}
+		m_removalsPending = true;
+	}
+	// the actors added since the last call to FindPairs don't have endpoints
+	while (m_oldIndices.size() <= last)
+	{
+		m_oldIndices.push_back(NO_INDEX);
+	}
+
+	// the moved actor is updated first so that removing the last actor marks it as removed
+	unsigned int moved = m_oldIndices[last];
+	unsigned int removed = m_oldIndices[index];
+	if (moved != NO_INDEX)
+	{
+		m_newIndices[moved] = index;
+	}
+	if (removed != NO_INDEX)
+	{
+		m_newIndices[removed] = NO_INDEX;
+	}
+	m_oldIndices[index] = moved;
+	m_oldIndices.pop_back();
+}
+void SweepAndPrune::QueryBounds(const Bounds & bounds, std::vector<unsigned int>& results) const
+{
+	// each actor has one min along the axis, so only the mins are looked at
+	unsigned int axis, begin, end;
+	FindRange(bounds, axis, begin, end);
+	for (unsigned int i = begin; i < end; i++)
+	{
+		const Endpoint& endpoint = m_endpoints[axis][i];
+		if (!endpoint.isMax && Overlap(m_bounds[endpoint.index], bounds))
+		{
+			results.push_back(endpoint.index);
+		}
+	}
+	for (unsigned int plane : m_unbounded)
+	{
+		if (Overlap(m_bounds[plane], bounds))
+		{
+			results.push_back(plane);
+		}
+	}
+}
+void SweepAndPrune::QueryRay(const glm::vec2 & start, const glm::vec2 & end, const float radius, std::vector<unsigned int>& results) const
+{
+	Bounds segment;
+	segment.min = glm::min(start, end) - radius;
+	segment.max = glm::max(start, end) + radius;
+
+	QuerySegment query(start, end, radius);
+	unsigned int axis, first, last;
+	FindRange(segment, axis, first, last);
+	for (unsigned int i = first; i < last; i++)
+	{
+		const Endpoint& endpoint = m_endpoints[axis][i];
+		if (!endpoint.isMax && query.Overlaps(m_bounds[endpoint.index]))
+		{
+			results.push_back(endpoint.index);
+		}
+	}
+	for (unsigned int plane : m_unbounded)
+	{
+		if (query.Overlaps(m_bounds[plane]))
+		{
+			results.push_back(plane);
+		}
+	}
+}
+
+void SweepAndPrune::Rebuild()
+{
+	// every existing pair is removed and then added again if it still overlaps
+	for (unsigned long long key : m_overlaps)
+	{
+		m_changes.push_back({ key, -1 });
+	}
+	m_overlaps.clear();
+
+	// creates the endpoints for every actor that has bounds
+	unsigned int unbounded = 0;
+	for (unsigned int axis = 0; axis < 2; axis++)
+	{
+		m_endpoints[axis].clear();
+	}
+	for (unsigned int i = 0; i < m_actorCount; i++)
+	{
+		if (unbounded < m_unbounded.size() && m_unbounded[unbounded] == i)
+		{
+			unbounded++;
+			continue;
+		}
+		for (unsigned int axis = 0; axis < 2; axis++)
+		{
+			m_endpoints[axis].push_back({ m_bounds[i].min[axis], i, false });
+			m_endpoints[axis].push_back({ m_bounds[i].max[axis], i, true });
+		}
+	}
+	std::sort(m_endpoints[0].begin(), m_endpoints[0].end(), Less);
+	std::sort(m_endpoints[1].begin(), m_endpoints[1].end(), Less);
+
+	// sweeps along the x axis keeping a list of the actors whose min has been passed but not their max
+	std::vector<unsigned int>& active = m_active;
+	active.clear();
+	for (const Endpoint& endpoint : m_endpoints[0])
+	{
+		if (!endpoint.isMax)
+		{
+			// every active actor overlaps this one on the x axis
+			for (unsigned int other : active)
+			{
+				if (Overlap(m_bounds[endpoint.index], m_bounds[other]))
+				{
+					AddPair(endpoint.index, other);
+				}
+			}
+			active.push_back(endpoint.index);
+		}
+		else
+		{
+			// the actor's max has been reached so it is removed from the active list
+			for (unsigned int i = 0; i < active.size(); i++)
+			{
+				if (active[i] == endpoint.index)
+				{
+					active[i] = active.back();
+					active.pop_back();
+					break;
+				}
+			}
+		}
+	}
+}
+
+void SweepAndPrune::ApplyRemovals()
+{
+	// drops the endpoints of the removed actors and renumbers the rest, the values don't change so the lists stay sorted
+	for (unsigned int axis = 0; axis < 2; axis++)
+	{
+		std::vector<Endpoint>& endpoints = m_endpoints[axis];
+		unsigned int count = 0;
+		for (unsigned int i = 0; i < endpoints.size(); i++)
+		{
+			unsigned int index = m_newIndices[endpoints[i].index];
+			if (index == NO_INDEX)
+			{
+				continue;
+			}
+			endpoints[count] = endpoints[i];
+			endpoints[count].index = index;
+			count++;
+		}
+		endpoints.resize(count);
+	}
+
+	// drops the pairs of the removed actors and renumbers the rest
+	// pushed one at a time so the vector grows in steps, copying the range would resize it to fit exactly each time
+	m_renumbered.clear();
+	for (unsigned long long key : m_overlaps)
+	{
+		m_renumbered.push_back(key);
+	}
+	m_overlaps.clear();
+	for (unsigned long long key : m_renumbered)
+	{
+		unsigned int index1 = m_newIndices[(unsigned int)(key >> 32)];
+		unsigned int index2 = m_newIndices[(unsigned int)(key & 0xFFFFFFFF)];
+		if (index1 != NO_INDEX && index2 != NO_INDEX)
+		{
+			m_overlaps.insert(Key(index1, index2));
+		}
+	}
+
+	m_removalsPending = false;
+}
+
+void SweepAndPrune::SortAxis(const unsigned int axis)
+{
+	std::vector<Endpoint>& endpoints = m_endpoints[axis];
+	for (unsigned int i = 1; i < endpoints.size(); i++)
+	{
+		Endpoint endpoint = endpoints[i];
+		int j = i - 1;
+		// moves the endpoint down the list until it is in order
+		while (j >= 0 && Less(endpoint, endpoints[j]))
+		{
+			const Endpoint& other = endpoints[j];
+			if (endpoint.index != other.index)
+			{
+				// a min moving below a max means the actors may have started overlapping
+				if (!endpoint.isMax && other.isMax)
+				{
+					if (Overlap(m_bounds[endpoint.index], m_bounds[other.index]))
+					{
+						AddPair(endpoint.index, other.index);
+					}
+				}
+				// a max moving below a min means the actors can no longer be overlapping
+				else if (endpoint.isMax && !other.isMax)
+				{
+					RemovePair(endpoint.index, other.index);
+				}
+			}
+			endpoints[j + 1] = endpoints[j];
+			j--;
+		}
+		endpoints[j + 1] = endpoint;
+	}
+}
+
+void SweepAndPrune::AddPair(const unsigned int index1, const unsigned int index2)
+{
+	unsigned long long key = Key(index1, index2);
+	// only records the change if the pair was not already overlapping
+	if (m_overlaps.insert(key).second)
+	{
+		m_changes.push_back({ key, 1 });
+	}
+}
+void SweepAndPrune::RemovePair(const unsigned int index1, const unsigned int index2)
+{
+	unsigned long long key = Key(index1, index2);
+	// only records the change if the pair was overlapping
+	if (m_overlaps.erase(key) > 0)
+	{
+		m_changes.push_back({ key, -1 });
+	}
+}
+
+bool SweepAndPrune::Less(const Endpoint & endpoint1, const Endpoint & endpoint2)
+{
+	if (endpoint1.value != endpoint2.value)
+	{
+		return endpoint1.value < endpoint2.value;
+	}
+	// a min is placed before a max with the same value
+	return !endpoint1.isMax && endpoint2.isMax;
+}
+unsigned long long SweepAndPrune::Key(const unsigned int index1, const unsigned int index2)
+{
+	unsigned long long first = (index1 < index2) ? index1 : index2;
+	unsigned long long second = (index1 < index2) ? index2 : index1;
+	return (first << 32) | second;
+}
+void SweepAndPrune::FindRange(const Bounds & bounds, unsigned int & axis, unsigned int & begin, unsigned int & end) const
+{
+	axis = 0;
+	begin = 0;
+	end = 0;
+	for (unsigned int i = 0; i < 2; i++)
+	{
+		const std::vector<Endpoint>& endpoints = m_endpoints[i];
+		float lowest = bounds.min[i] - m_maxSize[i];
+		float highest = bounds.max[i];
+		unsigned int first = std::lower_bound(endpoints.begin(), endpoints.end(), lowest,
+			[](const Endpoint& endpoint, const float value) { return endpoint.value < value; }) - endpoints.begin();
+		unsigned int last = std::upper_bound(endpoints.begin(), endpoints.end(), highest,
+			[](const float value, const Endpoint& endpoint) { return value < endpoint.value; }) - endpoints.begin();
+		if (last < first)
+		{
+			last = first;
+		}
+		if (i == 0 || last - first < end - begin)
+		{
+			axis = i;
+			begin = first;
+			end = last;
+		}
+	}
+}
\ No newline at end of file
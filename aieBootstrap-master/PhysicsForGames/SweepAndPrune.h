@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Broadphase.h"
+#include <unordered_set>
+#include "ObjectPool.h"
+
+// the min or max of an actor's bounds along one axis
+struct Endpoint
+{
+	// the position of the endpoint along the axis
+	float value;
+	// index of the actor in the scene
+	unsigned int index;
+	// true for the max of the bounds, false for the min
+	bool isMax;
+};
+
+// keeps the bounds of the actors sorted along the x and y axis between steps
+// because actors only move a small amount each step the lists are nearly sorted, so insertion sort is close to linear
+// whenever a min and a max swap places the overlap of that pair has changed
+class SweepAndPrune : public Broadphase
+{
+public:
+	SweepAndPrune();
+	~SweepAndPrune();
+
+	// updates the sorted endpoints and fills the collection with the pairs of actors whose bounds overlap
+	virtual void FindPairs(const std::vector<PhysicsObject*>& actors, std::vector<CollisionPair>& pairs);
+	// records that the actor was removed and the last actor moved into its place
+	// the endpoints are only updated on the next call to FindPairs, so removing many actors in one step costs a single pass
+	virtual void OnActorRemoved(const unsigned int index, const unsigned int last);
+	// searches the sorted endpoints of whichever axis has the fewest in the range of the bounds
+	virtual void QueryBounds(const Bounds& bounds, std::vector<unsigned int>& results) const;
+	// searches the range of the bounds of the segment, so a long diagonal ray checks more actors than it would with the other broadphases
+	virtual void QueryRay(const glm::vec2& start, const glm::vec2& end, const float radius, std::vector<unsigned int>& results) const;
+
+	// the pairs that started overlapping during the last call to FindPairs
+	const std::vector<CollisionPair>& GetAddedPairs() const { return m_addedPairs; }
+	// the pairs that stopped overlapping during the last call to FindPairs
+	const std::vector<CollisionPair>& GetRemovedPairs() const { return m_removedPairs; }
+
+protected:
+	// sorts the endpoints from scratch and finds every overlapping pair with a single sweep
+	void Rebuild();
+	// drops the endpoints and pairs of the removed actors and renumbers the moved actors
+	void ApplyRemovals();
+	// insertion sorts the endpoints along one axis, adding and removing pairs as mins and maxes swap
+	void SortAxis(const unsigned int axis);
+	// marks the pair as overlapping
+	void AddPair(const unsigned int index1, const unsigned int index2);
+	// marks the pair as no longer overlapping
+	void RemovePair(const unsigned int index1, const unsigned int index2);
+
+	// sorts by value, with mins before maxes so that touching bounds count as overlapping
+	static bool Less(const Endpoint& endpoint1, const Endpoint& endpoint2);
+	// combines the indices of a pair into a single value with the smaller index first
+	static unsigned long long Key(const unsigned int index1, const unsigned int index2);
+	// finds the endpoints of the actors that can overlap the bounds along the axis with the fewest of them
+	// an actor can only overlap if its min is inside the bounds or at most the size of the largest actor before them
+	void FindRange(const Bounds& bounds, unsigned int& axis, unsigned int& begin, unsigned int& end) const;
+
+protected:
+	// the number of actors the endpoints have been created for
+	unsigned int m_actorCount;
+	// the index each actor had at the last call to FindPairs, indexed by where the actor is now
+	// only kept while there are removals waiting to be applied
+	std::vector<unsigned int> m_oldIndices;
+	// where each actor from the last call to FindPairs is now, indexed by the index it had then
+	std::vector<unsigned int> m_newIndices;
+	// the actors that need endpoints created for them this step
+	std::vector<unsigned int> m_newActors;
+	// set when actors have been removed since the last call to FindPairs
+	bool m_removalsPending;
+	// the endpoints along the x axis [0] and the y axis [1]
+	std::vector<Endpoint> m_endpoints[2];
+	// the bounds of each actor this step
+	std::vector<Bounds> m_bounds;
+	// the largest width and height of the bounds this step, not counting planes
+	glm::vec2 m_maxSize;
+	// the actors without endpoints because they are infinite (i.e. planes)
+	std::vector<unsigned int> m_unbounded;
+	// the pairs that currently overlap
+	std::unordered_set<unsigned long long, std::hash<unsigned long long>, std::equal_to<unsigned long long>,
+		PoolAllocator<unsigned long long>> m_overlaps;
+	// every pair that was added (+1) or removed (-1) this step
+	std::vector<std::pair<unsigned long long, int>> m_changes;
+	std::vector<CollisionPair> m_addedPairs;
+	std::vector<CollisionPair> m_removedPairs;
+	// reused by Rebuild for the actors whose min has been passed but not their max
+	std::vector<unsigned int> m_active;
+	// reused by ApplyRemovals for the pairs being renumbered
+	std::vector<unsigned long long> m_renumbered;
+};
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include "UniformGrid.h"
+#include <algorithm>
+#include <limits>
+
+// actors that cover more cells than this are treated as large and checked against every actor
+#define MAX_CELLS_PER_ACTOR 64.0f
+// stops cell coordinates from overflowing an int when actors are very far from the origin
+#define MAX_CELL_COORDINATE 1000000000.0f
+
+UniformGrid::UniformGrid(const float cellSize)
+{
+	m_cellSize = cellSize;
+	m_inverseCellSize = 1.0f;
+	m_gridBounds.min = glm::vec2(0.0f, 0.0f);
+	m_gridBounds.max = glm::vec2(0.0f, 0.0f);
+	m_bucketCount = 0;
+}
+UniformGrid::~UniformGrid()
+{
+}
+
+void UniformGrid::FindPairs(const std::vector<PhysicsObject*>& actors, std::vector<CollisionPair>& pairs)
+{
+	pairs.clear();
+	m_large.clear();
+	m_entries.clear();
+
+	unsigned int actorCount = actors.size();
+	m_bounds.resize(actorCount);
+
+	// gets the bounds of every actor once so they don't need to be recalculated for each pair
+	float totalSize = 0.0f;
+	unsigned int boundedCount = 0;
+	for (unsigned int i = 0; i < actorCount; i++)
+	{
+		m_bounds[i] = GetActorBounds(actors[i]);
+		// planes are infinite so they are not used to size the cells
+		if (actors[i]->GetShapeType() != PLANE)
+		{
+			totalSize += fmaxf(m_bounds[i].max.x - m_bounds[i].min.x, m_bounds[i].max.y - m_bounds[i].min.y);
+			boundedCount++;
+		}
+	}
+
+	// uses double the average actor size when the cell size is automatic so most actors only cover a few cells
+	float cellSize = m_cellSize;
+	if (cellSize <= 0.0f)
+	{
+		cellSize = (boundedCount > 0 && totalSize > 0.0f) ? 2.0f * totalSize / boundedCount : 1.0f;
+	}
+	float inverseCellSize = 1.0f / cellSize;
+	m_inverseCellSize = inverseCellSize;
+
+	// places each actor into every cell that its bounds cover
+	m_gridBounds.min = glm::vec2(std::numeric_limits<float>::max());
+	m_gridBounds.max = glm::vec2(std::numeric_limits<float>::lowest());
+	for (unsigned int i = 0; i < actorCount; i++)
+	{
+		const Bounds& bounds = m_bounds[i];
+		glm::vec2 minCell = glm::floor(bounds.min * inverseCellSize);
+		glm::vec2 maxCell = glm::floor(bounds.max * inverseCellSize);
+		glm::vec2 cellCount = maxCell - minCell + glm::vec2(1.0f, 1.0f);
+
+		// checks if the actor is too big or too far away to be placed into cells
+		// the comparisons are negated so that invalid values are also treated as large
+		if (!(cellCount.x * cellCount.y <= MAX_CELLS_PER_ACTOR) ||
+			!(fabsf(minCell.x) < MAX_CELL_COORDINATE && fabsf(minCell.y) < MAX_CELL_COORDINATE &&
+			fabsf(maxCell.x) < MAX_CELL_COORDINATE && fabsf(maxCell.y) < MAX_CELL_COORDINATE))
+		{
+			m_large.push_back(i);
+			continue;
+		}
+
+		for (int y = (int)minCell.y; y <= (int)maxCell.y; y++)
+		{
+			for (int x = (int)minCell.x; x <= (int)maxCell.x; x++)
+			{
+				m_entries.push_back({ x, y, i });
+			}
+		}
+		m_gridBounds.min = glm::min(m_gridBounds.min, bounds.min);
+		m_gridBounds.max = glm::max(m_gridBounds.max, bounds.max);
+	}
+
+	// uses twice as many buckets as entries to keep the chance of two cells sharing a bucket low
+	m_bucketCount = 16;
+	while (m_bucketCount < m_entries.size() * 2)
+	{
+		m_bucketCount *= 2;
+	}
+
+	// counting sort of the entries into their buckets
+	// the sort is stable so the entries in each bucket stay in the order of the actors
+	m_bucketEnd.assign(m_bucketCount, 0);
+	for (const GridEntry& entry : m_entries)
+	{
+		m_bucketEnd[Hash(entry.x, entry.y)]++;
+	}
+	unsigned int total = 0;
+	for (unsigned int i = 0; i < m_bucketCount; i++)
+	{
+		// stores where the bucket starts, which becomes where it ends once it has been filled
+		unsigned int count = m_bucketEnd[i];
+		m_bucketEnd[i] = total;
+		total += count;
+	}
+	m_sorted.resize(m_entries.size());
+	for (const GridEntry& entry : m_entries)
+	{
+		m_sorted[m_bucketEnd[Hash(entry.x, entry.y)]++] = entry;
+	}
+
+	// checks the actors in each cell against each other
+	unsigned int bucketStart = 0;
+	for (unsigned int bucket = 0; bucket < m_bucketCount; bucket++)
+	{
+		unsigned int bucketEnd = m_bucketEnd[bucket];
+		for (unsigned int i = bucketStart; i < bucketEnd; i++)
+		{
+			const GridEntry& entry1 = m_sorted[i];
+			for (unsigned int j = i + 1; j < bucketEnd; j++)
+			{
+				const GridEntry& entry2 = m_sorted[j];
+				// different cells can share a bucket
+				if (entry1.x != entry2.x || entry1.y != entry2.y)
+				{
+					continue;
+				}
+
+				const Bounds& bounds1 = m_bounds[entry1.index];
+				const Bounds& bounds2 = m_bounds[entry2.index];
+				if (!Overlap(bounds1, bounds2))
+				{
+					continue;
+				}
+
+				// actors can share more than one cell, so only the cell containing the bottom left corner of the overlapping area reports the pair
+				glm::vec2 corner = glm::floor(glm::max(bounds1.min, bounds2.min) * inverseCellSize);
+				if ((int)corner.x == entry1.x && (int)corner.y == entry1.y)
+				{
+					pairs.push_back({ entry1.index, entry2.index });
+				}
+			}
+		}
+		bucketStart = bucketEnd;
+	}
+
+	// checks the large actors against every other actor
+	for (unsigned int large : m_large)
+	{
+		for (unsigned int i = 0; i < actorCount; i++)
+		{
+			// two large actors are only paired once
+			if (i == large || (i < large && std::binary_search(m_large.begin(), m_large.end(), i)))
+			{
+				continue;
+			}
+			// planes can't collide with each other
+			if (actors[i]->GetShapeType() == PLANE && actors[large]->GetShapeType() == PLANE)
+			{
+				continue;
+			}
+
+			if (Overlap(m_bounds[large], m_bounds[i]))
+			{
+				pairs.push_back({ std::min(large, i), std::max(large, i) });
+			}
+		}
+	}
+
+	std::sort(pairs.begin(), pairs.end(), ComparePairs);
+}
+
+void UniformGrid::QueryBounds(const Bounds & bounds, std::vector<unsigned int>& results) const
+{
+	unsigned int first = results.size();
+	auto overlaps = [&](const Bounds& actor)
+	{
+		return Overlap(actor, bounds);
+	};
+
+	if (!m_sorted.empty() && Overlap(bounds, m_gridBounds))
+	{
+		// only the part of the bounds over the grid can have any actors in its cells
+		glm::vec2 minCell = glm::floor(glm::max(bounds.min, m_gridBounds.min) * m_inverseCellSize);
+		glm::vec2 maxCell = glm::floor(glm::min(bounds.max, m_gridBounds.max) * m_inverseCellSize);
+		glm::vec2 cellCount = maxCell - minCell + glm::vec2(1.0f, 1.0f);
+		// looking in more cells than there are entries is slower than checking every actor
+		if (cellCount.x * cellCount.y > m_sorted.size())
+		{
+			for (unsigned int i = 0; i < m_bounds.size(); i++)
+			{
+				if (overlaps(m_bounds[i]))
+				{
+					results.push_back(i);
+				}
+			}
+			return;
+		}
+
+		for (int y = (int)minCell.y; y <= (int)maxCell.y; y++)
+		{
+			for (int x = (int)minCell.x; x <= (int)maxCell.x; x++)
+			{
+				QueryCell(x, y, overlaps, results);
+			}
+		}
+	}
+	for (unsigned int large : m_large)
+	{
+		if (overlaps(m_bounds[large]))
+		{
+			results.push_back(large);
+		}
+	}
+
+	// an actor that covers more than one of the cells is found in each of them
+	std::sort(results.begin() + first, results.end());
+	results.erase(std::unique(results.begin() + first, results.end()), results.end());
+}
+void UniformGrid::QueryRay(const glm::vec2 & start, const glm::vec2 & end, const float radius, std::vector<unsigned int>& results) const
+{
+	unsigned int first = results.size();
+	QuerySegment segment(start, end, radius);
+	auto passes = [&](const Bounds& actor)
+	{
+		return segment.Overlaps(actor);
+	};
+
+	float enter, exit;
+	if (!m_sorted.empty() && segment.Clip(m_gridBounds, enter, exit))
+	{
+		// only the part of the segment over the grid can pass through any cells with actors in them
+		glm::vec2 displacement = end - start;
+		glm::vec2 firstCell = glm::floor((start + displacement * enter) * m_inverseCellSize);
+		glm::vec2 lastCell = glm::floor((start + displacement * exit) * m_inverseCellSize);
+		// the cells within the radius of the segment are looked in as well
+		int reach = (int)ceilf(radius * m_inverseCellSize);
+		float cellsPerStep = (2.0f * reach + 1.0f) * (2.0f * reach + 1.0f);
+		// looking in more cells than there are entries is slower than checking every actor
+		if ((fabsf(lastCell.x - firstCell.x) + fabsf(lastCell.y - firstCell.y) + 1.0f) * cellsPerStep > m_sorted.size())
+		{
+			for (unsigned int i = 0; i < m_bounds.size(); i++)
+			{
+				if (passes(m_bounds[i]))
+				{
+					results.push_back(i);
+				}
+			}
+			return;
+		}
+
+		// steps from cell to cell across whichever side the segment leaves through first (Amanatides and Woo)
+		float cellSize = 1.0f / m_inverseCellSize;
+		int x = (int)firstCell.x;
+		int y = (int)firstCell.y;
+		int lastX = (int)lastCell.x;
+		int lastY = (int)lastCell.y;
+		int stepX = (displacement.x > 0.0f) ? 1 : -1;
+		int stepY = (displacement.y > 0.0f) ? 1 : -1;
+		// the fractions of the segment where it crosses into the next column and row, and how far apart the crossings are
+		float nextX = std::numeric_limits<float>::max();
+		float nextY = std::numeric_limits<float>::max();
+		float deltaX = std::numeric_limits<float>::max();
+		float deltaY = std::numeric_limits<float>::max();
+		if (displacement.x != 0.0f)
+		{
+			nextX = ((x + (stepX > 0 ? 1 : 0)) * cellSize - start.x) / displacement.x;
+			deltaX = cellSize / fabsf(displacement.x);
+		}
+		if (displacement.y != 0.0f)
+		{
+			nextY = ((y + (stepY > 0 ? 1 : 0)) * cellSize - start.y) / displacement.y;
+			deltaY = cellSize / fabsf(displacement.y);
+		}
+
+		float pieceStart = enter;
+		while (true)
+		{
+			// only the cells within the radius of the part of the segment in this cell, which is usually just this cell
+			float pieceEnd = fminf(fminf(nextX, nextY), exit);
+			glm::vec2 point1 = start + displacement * pieceStart;
+			glm::vec2 point2 = start + displacement * pieceEnd;
+			glm::vec2 minCell = glm::min(glm::floor((glm::min(point1, point2) - radius) * m_inverseCellSize), glm::vec2(x, y));
+			glm::vec2 maxCell = glm::max(glm::floor((glm::max(point1, point2) + radius) * m_inverseCellSize), glm::vec2(x, y));
+			for (int cellY = std::max((int)minCell.y, y - reach); cellY <= std::min((int)maxCell.y, y + reach); cellY++)
+			{
+				for (int cellX = std::max((int)minCell.x, x - reach); cellX <= std::min((int)maxCell.x, x + reach); cellX++)
+				{
+					QueryCell(cellX, cellY, passes, results);
+				}
+			}
+			if (x == lastX && y == lastY)
+			{
+				break;
+			}
+			// once a column or row has reached the last cell only the other one moves, so rounding can't walk past it
+			if (y == lastY || (x != lastX && nextX < nextY))
+			{
+				x += stepX;
+				nextX += deltaX;
+			}
+			else
+			{
+				y += stepY;
+				nextY += deltaY;
+			}
+			pieceStart = pieceEnd;
+		}
+	}
+	for (unsigned int large : m_large)
+	{
+		if (passes(m_bounds[large]))
+		{
+			results.push_back(large);
+		}
+	}
+
+	// an actor that covers more than one of the cells is found in each of them
+	std::sort(results.begin() + first, results.end());
+	results.erase(std::unique(results.begin() + first, results.end()), results.end());
+}
+
+unsigned int UniformGrid::Hash(const int x, const int y) const
+{
+	// multiplies the coordinates by large primes so that neighbouring cells are spread across the table
+	return (((unsigned int)x * 73856093U) ^ ((unsigned int)y * 19349663U)) & (m_bucketCount - 1);
+}
\ No newline at end of file
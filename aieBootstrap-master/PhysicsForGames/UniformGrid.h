@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Broadphase.h"
+
+// an actor that has been placed into a grid cell
+struct GridEntry
+{
+	// coordinates of the cell
+	int x;
+	int y;
+	// index of the actor in the scene
+	unsigned int index;
+};
+
+// spatial hash that places actors into uniformly sized cells and only pairs actors that share a cell
+class UniformGrid : public Broadphase
+{
+public:
+	// a cell size of 0 will size the cells based on the average size of the actors
+	UniformGrid(const float cellSize = 0.0f);
+	~UniformGrid();
+
+	// fills the collection with the pairs of actors that share a cell and whose bounds overlap
+	virtual void FindPairs(const std::vector<PhysicsObject*>& actors, std::vector<CollisionPair>& pairs);
+	// looks in the cells covered by the bounds, or checks every actor if there are more of those cells than entries
+	virtual void QueryBounds(const Bounds& bounds, std::vector<unsigned int>& results) const;
+	// walks the cells that the segment passes through, along with the cells within the radius of them
+	virtual void QueryRay(const glm::vec2& start, const glm::vec2& end, const float radius, std::vector<unsigned int>& results) const;
+
+	void SetCellSize(const float cellSize) { m_cellSize = cellSize; }
+	float GetCellSize() const { return m_cellSize; }
+
+protected:
+	// gets the bucket that a cell is stored in
+	unsigned int Hash(const int x, const int y) const;
+	// adds the index of every actor in the cell whose bounds pass the test to the collection
+	template<typename Test>
+	void QueryCell(const int x, const int y, const Test& test, std::vector<unsigned int>& results) const
+	{
+		unsigned int bucket = Hash(x, y);
+		unsigned int begin = (bucket > 0) ? m_bucketEnd[bucket - 1] : 0;
+		for (unsigned int i = begin; i < m_bucketEnd[bucket]; i++)
+		{
+			// different cells can share a bucket
+			const GridEntry& entry = m_sorted[i];
+			if (entry.x == x && entry.y == y && test(m_bounds[entry.index]))
+			{
+				results.push_back(entry.index);
+			}
+		}
+	}
+
+protected:
+	// the width and height of each cell, 0 means automatic
+	float m_cellSize;
+	// 1 over the size of the cells used by the last call to FindPairs
+	float m_inverseCellSize;
+	// the bounds of all the actors that were placed into cells
+	Bounds m_gridBounds;
+	// the number of buckets in the hash table, always a power of 2
+	unsigned int m_bucketCount;
+	// the bounds of each actor this step
+	std::vector<Bounds> m_bounds;
+	// actors that cover too many cells (i.e. planes) and are checked against every other actor
+	std::vector<unsigned int> m_large;
+	// every cell that each actor covers
+	std::vector<GridEntry> m_entries;
+	// the entries sorted by bucket
+	std::vector<GridEntry> m_sorted;
+	// the index in the sorted entries where each bucket ends
+	std::vector<unsigned int> m_bucketEnd;
+};
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+// disjoint sets of indices, used to join touching rigidbodies into islands
+class UnionFind
+{
+public:
+	// puts every index from 0 up to but not including the count into a set of its own
+	void Reset(const unsigned int count)
+	{
+		m_parents.resize(count);
+		for (unsigned int i = 0; i < count; i++)
+		{
+			m_parents[i] = i;
+		}
+	}
+	// gets the index that represents the set the index is in
+	unsigned int Find(unsigned int index)
+	{
+		// points the indices at their grandparents while searching so the next search is shorter
+		while (m_parents[index] != index)
+		{
+			m_parents[index] = m_parents[m_parents[index]];
+			index = m_parents[index];
+		}
+		return index;
+	}
+	// joins the sets that the two indices are in
+	void Union(const unsigned int index1, const unsigned int index2)
+	{
+		m_parents[Find(index1)] = Find(index2);
+	}
+
+protected:
+	// the parent of each index, indices that are their own parent represent their set
+	std::vector<unsigned int> m_parents;
+};
\ No newline at end of file
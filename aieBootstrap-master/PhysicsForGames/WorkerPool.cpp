@@ -0,0 +1,125 @@
+#include "WorkerPool.h"
+
+WorkerPool::WorkerPool(const unsigned int threadCount) : m_queues(threadCount > 0 ? threadCount : 1)
+{
+	m_task = nullptr;
+	m_invoker = nullptr;
+	m_generation = 0;
+	m_remaining = 0;
+	m_quit = false;
+	m_steals = 0;
+
+	// the calling thread is thread 0
+	for (unsigned int i = 1; i < threadCount; i++)
+	{
+		m_threads.push_back(std::thread(&WorkerPool::WorkerLoop, this, i));
+	}
+}
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_quit = true;
+	}
+	m_start.notify_all();
+
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+void WorkerPool::RunTask(const void * task, const TaskInvoker invoker)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_task = task;
+		m_invoker = invoker;
+		m_remaining = m_threads.size();
+		m_generation++;
+	}
+	m_start.notify_all();
+
+	// does the work for thread 0 while the workers run
+	invoker(task, 0);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_finished.wait(lock, [this]() { return m_remaining == 0; });
+	m_task = nullptr;
+}
+void WorkerPool::DealTasks(const unsigned int count)
+{
+	// deals the indices out in turn so each thread starts with a share of the large pieces at the front of the order
+	unsigned int threadCount = GetThreadCount();
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		m_queues[i].indices.clear();
+	}
+	for (unsigned int i = 0; i < count; i++)
+	{
+		m_queues[i % threadCount].indices.push_back(i);
+	}
+	for (unsigned int i = 0; i < threadCount; i++)
+	{
+		m_queues[i].front = 0;
+		m_queues[i].back = m_queues[i].indices.size();
+	}
+}
+
+void WorkerPool::WorkerLoop(const unsigned int thread)
+{
+	unsigned int generation = 0;
+	while (true)
+	{
+		const void* task;
+		TaskInvoker invoker;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_start.wait(lock, [&]() { return m_quit || m_generation != generation; });
+			if (m_quit)
+			{
+				return;
+			}
+			generation = m_generation;
+			task = m_task;
+			invoker = m_invoker;
+		}
+
+		invoker(task, thread);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_remaining--;
+		}
+		m_finished.notify_one();
+	}
+}
+bool WorkerPool::PopTask(const unsigned int thread, unsigned int & index)
+{
+	TaskQueue& queue = m_queues[thread];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (queue.front == queue.back)
+	{
+		return false;
+	}
+	index = queue.indices[queue.front++];
+	return true;
+}
+bool WorkerPool::StealTask(const unsigned int thread, unsigned int & index)
+{
+	// starts with the next thread along so the threads that run out don't all steal from the same queue
+	unsigned int threadCount = GetThreadCount();
+	for (unsigned int i = 1; i < threadCount; i++)
+	{
+		TaskQueue& queue = m_queues[(thread + i) % threadCount];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.front != queue.back)
+		{
+			// the back of the queue holds the smallest pieces, leaving the owner the larger ones it is about to start
+			index = queue.indices[--queue.back];
+			m_steals++;
+			return true;
+		}
+	}
+	return false;
+}
\ No newline at end of file
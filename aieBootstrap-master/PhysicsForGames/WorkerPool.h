@@ -0,0 +1,115 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// a fixed set of threads that run the same task together, used to split the physics step across cores
+// the calling thread is counted as thread 0 and does its share of the work, so a pool of 4 threads only creates 3
+class WorkerPool
+{
+public:
+	WorkerPool(const unsigned int threadCount);
+	~WorkerPool();
+
+	// calls the task once on every thread with the index of the thread and returns when they have all finished
+	// the tasks are passed to the workers by pointer instead of being wrapped in a std::function, so running them never allocates
+	template<typename Task>
+	void Run(const Task& task)
+	{
+		RunTask(&task, [](const void* task, unsigned int thread)
+		{
+			(*static_cast<const Task*>(task))(thread);
+		});
+	}
+	// splits the range [0, count) into one contiguous block per thread, in order, and runs the task on each block
+	// the task is called with the begin, end and thread
+	template<typename Task>
+	void ParallelFor(const unsigned int count, const Task& task)
+	{
+		unsigned long long threadCount = GetThreadCount();
+		Run([&](unsigned int thread)
+		{
+			// the blocks only depend on the count and the amount of threads, so the same work always goes to the same thread
+			unsigned int begin = (unsigned int)((unsigned long long)count * thread / threadCount);
+			unsigned int end = (unsigned int)((unsigned long long)count * (thread + 1) / threadCount);
+			if (begin < end)
+			{
+				task(begin, end, thread);
+			}
+		});
+	}
+	// runs the task once for every index in [0, count), for work that is split into pieces of very different sizes
+	// the indices are dealt out to the threads in turn and a thread that runs out of work steals from the back of another
+	// thread's queue, so the pieces should be given in order from largest to smallest
+	// the task is called with the index and thread
+	template<typename Task>
+	void RunTasks(const unsigned int count, const Task& task)
+	{
+		DealTasks(count);
+		Run([&](unsigned int thread)
+		{
+			unsigned int index;
+			while (PopTask(thread, index) || StealTask(thread, index))
+			{
+				task(index, thread);
+			}
+		});
+	}
+
+	// the amount of tasks taken from another thread's queue since the statistics were reset
+	unsigned int GetSteals() const { return m_steals; }
+	void ResetStatistics() { m_steals = 0; }
+
+	unsigned int GetThreadCount() const { return m_threads.size() + 1; }
+
+protected:
+	// calls a task of the type it was made for
+	typedef void(*TaskInvoker)(const void* task, unsigned int thread);
+
+protected:
+	// starts the task on the workers, runs it on the calling thread and waits for the workers to finish
+	void RunTask(const void* task, const TaskInvoker invoker);
+	// puts the indices from 0 up to but not including the count into the queues in turn
+	void DealTasks(const unsigned int count);
+	// waits for tasks to be given to the pool
+	void WorkerLoop(const unsigned int thread);
+	// takes the next index from the front of the thread's own queue
+	bool PopTask(const unsigned int thread, unsigned int& index);
+	// takes an index from the back of the first other queue that isn't empty
+	bool StealTask(const unsigned int thread, unsigned int& index);
+
+protected:
+	// the indices waiting to be run by a thread, locked because other threads can steal from it
+	// the indices are only ever taken from the ends, so the waiting indices are the ones from front up to but not including back
+	struct TaskQueue
+	{
+		std::mutex mutex;
+		std::vector<unsigned int> indices;
+		unsigned int front;
+		unsigned int back;
+	};
+
+protected:
+	// the worker threads, not including the calling thread
+	std::vector<std::thread> m_threads;
+	std::mutex m_mutex;
+	// signalled when a task is started or the pool is shutting down
+	std::condition_variable m_start;
+	// signalled when a worker finishes the task
+	std::condition_variable m_finished;
+	// the task being run and the function that calls it
+	const void* m_task;
+	TaskInvoker m_invoker;
+	// incremented each time a task is started so the workers know there is new work
+	unsigned int m_generation;
+	// the amount of workers still running the task
+	unsigned int m_remaining;
+	// tells the workers to exit
+	bool m_quit;
+	// one queue for each thread, including the calling thread
+	std::vector<TaskQueue> m_queues;
+	std::atomic<unsigned int> m_steals;
+};
\ No newline at end of file
@@ -1,11 +1,19 @@
 #include "CollisionApp.h"
+#include "PhysicsCheck.h"
 #include <iostream>
+#include <cstring>
 
-int main()
+int main(int argc, char* argv[])
 {	
 	// log memory leaks
 	_CrtSetDbgFlag(_CRTDBG_ALLOC_MEM_DF | _CRTDBG_LEAK_CHECK_DF);
 
+	// runs the physics checks without opening a window
+	if (argc > 1 && strcmp(argv[1], "-check") == 0)
+	{
+		return PhysicsCheck::Run();
+	}
+
 	// allocation
 	auto app = new CollisionApp();
 